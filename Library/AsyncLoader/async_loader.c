@@ -0,0 +1,315 @@
+#include "..\list_t.h"
+#include "async_loader.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <pthread.h>
+
+/* ============= Misc ============= */
+
+// Number of bytes read from the file for each chunk
+#define LOADER_CHUNK (4 << 20)
+
+// Number of buffers for each parser thread, so that the reader can stay ahead of the parsers
+#define BUFFERS_PER_THREAD 2
+
+// A buffer of the ring, along with the position of its chunk inside the file
+struct loaderBuffer
+{
+	char* data;
+	size_t capacity;
+	size_t length;
+	int sequence;
+};
+
+// State shared by the reader and the parser threads, protected by the lock
+struct listLoader
+{
+	FILE* file;
+	char separator;
+	bool_t(*parser)(const char*, int, T*);
+	void(*callback)(list_t, void*);
+	void* ctx;
+	pthread_mutex_t lock;
+	pthread_cond_t changed;
+	pthread_t reader;
+	pthread_t* parsers;
+	int threads;
+	bool_t readerStarted;
+	int parsersStarted;
+	int running;
+
+	// The ring: empty buffers are in a stack, full buffers in a queue
+	struct loaderBuffer* buffers;
+	int count;
+	int* empty;
+	int emptyCount;
+	int* full;
+	int fullHead;
+	int fullCount;
+
+	// Parsed chunks waiting for the previous ones, indexed by sequence % count
+	list_t* pending;
+	int nextSequence;
+	int nextSplice;
+	list_t result;
+	bool_t finished;
+	bool_t failed;
+	bool_t completed;
+};
+
+// Marks the loading as failed and wakes up all the threads
+static inline void loaderFail(list_loader_t loader)
+{
+	loader->failed = TRUE;
+	pthread_cond_broadcast(&loader->changed);
+}
+
+// Lowers the number of running threads by the given count: the call that
+// stops the last one completes the loading
+static void loaderRelease(list_loader_t loader, int count)
+{
+	pthread_mutex_lock(&loader->lock);
+	loader->running -= count;
+	bool_t last = loader->running == 0;
+	pthread_mutex_unlock(&loader->lock);
+	if (!last) return;
+
+	// All the other threads are done, so there is no need to lock anymore
+	int i;
+	for (i = 0; i < loader->count; i++)
+	{
+		if (loader->pending[i] != NULL) destroy(loader->pending + i);
+	}
+	if (loader->failed || ferror(loader->file)) destroy(&loader->result);
+	if (loader->callback != NULL) loader->callback(loader->result, loader->ctx);
+	pthread_mutex_lock(&loader->lock);
+	loader->completed = TRUE;
+	pthread_cond_broadcast(&loader->changed);
+	pthread_mutex_unlock(&loader->lock);
+}
+
+// Called by each thread before it exits
+static inline void loaderExit(list_loader_t loader)
+{
+	loaderRelease(loader, 1);
+}
+
+/* ============= Threads ============= */
+
+// Reads the file inside the empty buffers, keeping the partial last item for the next chunk
+static void* readerThread(void* argument)
+{
+	list_loader_t loader = (list_loader_t)argument;
+	size_t carryCapacity = 4096, carryLength = 0;
+	char* carry = (char*)malloc(carryCapacity);
+	bool_t end = FALSE;
+	while (!end)
+	{
+		// Wait for an empty buffer, without getting too far ahead of the splicing
+		pthread_mutex_lock(&loader->lock);
+		while (!loader->failed && (loader->emptyCount == 0
+			|| loader->nextSequence - loader->nextSplice >= loader->count))
+		{
+			pthread_cond_wait(&loader->changed, &loader->lock);
+		}
+		if (loader->failed)
+		{
+			pthread_mutex_unlock(&loader->lock);
+			break;
+		}
+		struct loaderBuffer* buffer = loader->buffers + loader->empty[--loader->emptyCount];
+		buffer->sequence = loader->nextSequence++;
+		pthread_mutex_unlock(&loader->lock);
+
+		// Fill the buffer, growing it only if a single item is longer than a chunk
+		if (buffer->capacity < carryLength + LOADER_CHUNK)
+		{
+			buffer->capacity = carryLength + LOADER_CHUNK;
+			buffer->data = (char*)realloc(buffer->data, buffer->capacity);
+		}
+		memcpy(buffer->data, carry, carryLength);
+		buffer->length = carryLength;
+		size_t cut;
+		while (TRUE)
+		{
+			size_t count = fread(buffer->data + buffer->length, 1, buffer->capacity - buffer->length, loader->file);
+			buffer->length += count;
+			if (count == 0)
+			{
+				end = TRUE;
+				cut = buffer->length;
+				break;
+			}
+			cut = buffer->length;
+			while (cut > 0 && buffer->data[cut - 1] != loader->separator) cut--;
+			if (cut > 0) break;
+			if (buffer->length == buffer->capacity)
+			{
+				buffer->capacity <<= 1;
+				buffer->data = (char*)realloc(buffer->data, buffer->capacity);
+			}
+		}
+
+		// Move the partial last item to the carry buffer
+		carryLength = buffer->length - cut;
+		if (carryLength > carryCapacity)
+		{
+			carryCapacity = carryLength;
+			carry = (char*)realloc(carry, carryCapacity);
+		}
+		memcpy(carry, buffer->data + cut, carryLength);
+		buffer->length = cut;
+
+		// Send the buffer to the parsers
+		pthread_mutex_lock(&loader->lock);
+		loader->full[(loader->fullHead + loader->fullCount++) % loader->count] = (int)(buffer - loader->buffers);
+		pthread_cond_broadcast(&loader->changed);
+		pthread_mutex_unlock(&loader->lock);
+	}
+	free(carry);
+	pthread_mutex_lock(&loader->lock);
+	loader->finished = TRUE;
+	if (ferror(loader->file)) loaderFail(loader);
+	pthread_cond_broadcast(&loader->changed);
+	pthread_mutex_unlock(&loader->lock);
+	loaderExit(loader);
+	return NULL;
+}
+
+// Parses the full buffers and splices the chunks that are ready into the final list_t
+static void* parserThread(void* argument)
+{
+	list_loader_t loader = (list_loader_t)argument;
+	while (TRUE)
+	{
+		pthread_mutex_lock(&loader->lock);
+		while (!loader->failed && !loader->finished && loader->fullCount == 0)
+		{
+			pthread_cond_wait(&loader->changed, &loader->lock);
+		}
+		if (loader->failed || loader->fullCount == 0)
+		{
+			pthread_mutex_unlock(&loader->lock);
+			break;
+		}
+		int index = loader->full[loader->fullHead];
+		loader->fullHead = (loader->fullHead + 1) % loader->count;
+		loader->fullCount--;
+		pthread_mutex_unlock(&loader->lock);
+
+		// Parse the chunk outside of the lock
+		struct loaderBuffer* buffer = loader->buffers + index;
+		list_t chunk = list_parse(buffer->data, buffer->length, loader->separator, loader->parser);
+
+		// Release the buffer and splice all the consecutive chunks that are ready
+		pthread_mutex_lock(&loader->lock);
+		loader->empty[loader->emptyCount++] = index;
+		if (chunk == NULL) loaderFail(loader);
+		else
+		{
+			loader->pending[buffer->sequence % loader->count] = chunk;
+			list_t* next;
+			while (*(next = loader->pending + loader->nextSplice % loader->count) != NULL)
+			{
+				list_splice_back(loader->result, *next);
+				destroy(next);
+				loader->nextSplice++;
+			}
+			pthread_cond_broadcast(&loader->changed);
+		}
+		pthread_mutex_unlock(&loader->lock);
+	}
+	loaderExit(loader);
+	return NULL;
+}
+
+/* ============= Loader ============= */
+
+// ListLoadAsync
+list_loader_t list_load_async(const char* path, char separator, bool_t(*parser)(const char*, int, T*),
+	int threads, void(*callback)(list_t, void*), void* ctx)
+{
+	if (path == NULL || threads <= 0) return NULL;
+
+	// Let list_parse check if T can be parsed without a custom parser
+	list_t check = list_parse("", 0, separator, parser);
+	if (check == NULL) return NULL;
+	destroy(&check);
+	FILE* file = fopen(path, "rb");
+	if (file == NULL) return NULL;
+
+	list_loader_t loader = (list_loader_t)calloc(1, sizeof(struct listLoader));
+	loader->file = file;
+	loader->separator = separator;
+	loader->parser = parser;
+	loader->callback = callback;
+	loader->ctx = ctx;
+	loader->threads = threads;
+	loader->count = threads * BUFFERS_PER_THREAD + 1;
+	loader->buffers = (struct loaderBuffer*)calloc(loader->count, sizeof(struct loaderBuffer));
+	loader->empty = (int*)malloc(loader->count * sizeof(int));
+	loader->full = (int*)malloc(loader->count * sizeof(int));
+	loader->pending = (list_t*)calloc(loader->count, sizeof(list_t));
+	loader->result = create();
+	int i;
+	for (i = 0; i < loader->count; i++) loader->empty[i] = i;
+	loader->emptyCount = loader->count;
+	pthread_mutex_init(&loader->lock, NULL);
+	pthread_cond_init(&loader->changed, NULL);
+
+	// The number of running threads is set first, so that none of them can complete the loading early
+	loader->parsers = (pthread_t*)malloc(threads * sizeof(pthread_t));
+	loader->running = threads + 1;
+	loader->readerStarted = pthread_create(&loader->reader, NULL, readerThread, loader) == 0;
+	while (loader->readerStarted && loader->parsersStarted < threads)
+	{
+		if (pthread_create(loader->parsers + loader->parsersStarted, NULL, parserThread, loader) != 0) break;
+		loader->parsersStarted++;
+	}
+
+	// If a thread can't be started the loading fails, and the threads that
+	// were never started are no longer counted as running
+	int missing = threads + 1 - loader->parsersStarted - (loader->readerStarted ? 1 : 0);
+	if (missing > 0)
+	{
+		pthread_mutex_lock(&loader->lock);
+		loaderFail(loader);
+		pthread_mutex_unlock(&loader->lock);
+		loaderRelease(loader, missing);
+	}
+	return loader;
+}
+
+// LoaderCompleted
+bool_t loader_completed(list_loader_t loader)
+{
+	if (loader == NULL) return FALSE;
+	pthread_mutex_lock(&loader->lock);
+	bool_t completed = loader->completed;
+	pthread_mutex_unlock(&loader->lock);
+	return completed;
+}
+
+// LoaderWait
+list_t loader_wait(list_loader_t* loader)
+{
+	if (*loader == NULL) return NULL;
+	list_loader_t target = *loader;
+	int i;
+	if (target->readerStarted) pthread_join(target->reader, NULL);
+	for (i = 0; i < target->parsersStarted; i++) pthread_join(target->parsers[i], NULL);
+	list_t result = target->result;
+	for (i = 0; i < target->count; i++) free(target->buffers[i].data);
+	fclose(target->file);
+	pthread_mutex_destroy(&target->lock);
+	pthread_cond_destroy(&target->changed);
+	free(target->buffers);
+	free(target->empty);
+	free(target->full);
+	free(target->pending);
+	free(target->parsers);
+	free(target);
+	*loader = NULL;
+	return result;
+}
@@ -0,0 +1,75 @@
+#ifndef ASYNC_LOADER_H
+#define ASYNC_LOADER_H
+
+#include "..\list_t.h"
+
+/* =====================================================================
+*  Asynchronous loading
+*  =====================================================================
+*  Description:
+*    Functions that load a list_t from a text file in the background
+*    (see list_parse for the format of the file). A reader thread fills
+*    a ring of large buffers, each one cut after the last separator it
+*    contains, while one or more parser threads convert them into list_t
+*    chunks. The chunks are moved at the end of the final list_t in O(1)
+*    and in the same order of the file, as soon as they are ready.
+*  NOTE:
+*    These functions need the POSIX threads library (-lpthread).
+*    The parser and the callback are called from the loader threads, so
+*    they must be thread safe and they can't be lambda expressions
+*    declared inside a function that returns before loader_wait. */
+
+typedef struct listLoader* list_loader_t;
+
+/* ---------------------------------------------------------------------
+*  ListLoadAsync
+*  ---------------------------------------------------------------------
+*  Description:
+*    Opens the given file and starts loading it in the background, then
+*    returns the loader right away. Returns NULL if the file can't be
+*    opened, if the number of threads is not valid, or if the parser is
+*    NULL and T is not int.
+*    When the loading is completed, the callback (if not NULL) receives
+*    the final list_t, or NULL if the file was not valid, along with the
+*    given context. The list_t is still owned by the loader until it is
+*    returned by loader_wait, so the callback must not modify it.
+*    If one of the threads can't be started, the loading fails just like
+*    with an invalid file, and the callback may be called before this
+*    function returns.
+*  Example:
+*    list_loader_t loader = list_load_async("items.txt", '\n', NULL, 2, NULL, NULL);
+*    // Other work...
+*    list_t list = loader_wait(&loader);
+*  Parameters:
+*    path ---> The path of the file to load
+*    separator ---> The character that divides two items
+*    parser ---> The function that parses a single item, or NULL
+*    threads ---> The number of parser threads, at least 1
+*    callback ---> The function to call when the loading is completed, or NULL
+*    ctx ---> The context to pass to the callback */
+list_loader_t list_load_async(const char* path, char separator, bool_t(*parser)(const char*, int, T*),
+	int threads, void(*callback)(list_t, void*), void* ctx);
+
+/* ---------------------------------------------------------------------
+*  LoaderCompleted
+*  ---------------------------------------------------------------------
+*  Description:
+*    Returns TRUE if the loading is completed (and the callback has
+*    returned), without waiting for it.
+*  Parameters:
+*    loader ---> The input loader */
+bool_t loader_completed(list_loader_t loader);
+
+/* ---------------------------------------------------------------------
+*  LoaderWait
+*  ---------------------------------------------------------------------
+*  Description:
+*    Waits for the loading to be completed, then deallocates the loader,
+*    sets it to NULL and returns the loaded list_t. Returns NULL if the
+*    loader was already NULL, if the file can't be read or if an item
+*    is not valid.
+*  Parameters:
+*    loader ---> A pointer to the target loader */
+list_t loader_wait(list_loader_t* loader);
+
+#endif
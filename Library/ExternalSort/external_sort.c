@@ -0,0 +1,225 @@
+#include "..\list_t.h"
+#include "..\Introsort\introsort.h"
+#include "..\Serialization\serialization.h"
+#include "external_sort.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <limits.h>
+
+/* ============= Misc ============= */
+
+// Minimum number of items sorted in memory for each run
+#define MIN_RUN 4096
+
+// Minimum number of items buffered for each run during a merge
+#define MIN_BLOCK 1024
+
+// Maximum number of runs merged at the same time, to stay well below the limit of open files
+#define MAX_WAYS 128
+
+// Sorted run spilled to a temporary file, along with the block of items being merged
+struct run
+{
+	FILE* file;
+	T* buffer;
+	int length;
+	int position;
+};
+
+// Returns the first item of a run that has not been merged yet
+#define HEAD(index) (runs[index].buffer[runs[index].position])
+
+// Reads the next block of a run, returns FALSE when the run has been consumed
+static inline bool_t runFill(struct run* run, int block)
+{
+	run->position = 0;
+	run->length = (int)fread(run->buffer, sizeof(T), block, run->file);
+	return run->length > 0;
+}
+
+// Moves down the first run of the heap, ordering the runs by their first item
+static void heapSiftDown(int* heap, int size, int root, struct run* runs, comparation(*expression)(T, T))
+{
+	int child;
+	while ((child = (root << 1) + 1) < size)
+	{
+		if (child + 1 < size && expression(HEAD(heap[child + 1]), HEAD(heap[child])) == LOWER) child++;
+		if (expression(HEAD(heap[child]), HEAD(heap[root])) != LOWER) return;
+		int temp = heap[root];
+		heap[root] = heap[child];
+		heap[child] = temp;
+		root = child;
+	}
+}
+
+/* ============= Merge ============= */
+
+// Writes a block of merged items to a temporary file or to the final writer
+static inline bool_t flushBlock(const T* items, int count, FILE* target, list_writer_t writer)
+{
+	if (writer != NULL) return list_writer_write(writer, items, count);
+	return fwrite(items, sizeof(T), count, target) == (size_t)count;
+}
+
+// Merges the given runs into a temporary file, or into the writer if it is not NULL
+static bool_t mergeRuns(FILE** files, int count, size_t budget, FILE* target,
+	list_writer_t writer, comparation(*expression)(T, T))
+{
+	// Split the budget between the input runs and the output block
+	size_t items = budget / sizeof(T) / (count + 1);
+	int block = items < MIN_BLOCK ? MIN_BLOCK : items > INT_MAX ? INT_MAX : (int)items;
+	struct run* runs = (struct run*)malloc(count * sizeof(struct run));
+	int* heap = (int*)malloc(count * sizeof(int));
+	T* output = (T*)malloc(block * sizeof(T));
+	int i, size = 0, used = 0;
+	bool_t result = TRUE;
+
+	// Load the first block of each run and build the heap
+	for (i = 0; i < count; i++)
+	{
+		runs[i].file = files[i];
+		runs[i].buffer = (T*)malloc(block * sizeof(T));
+		rewind(files[i]);
+		if (runFill(runs + i, block)) heap[size++] = i;
+	}
+	for (i = size / 2 - 1; i >= 0; i--) heapSiftDown(heap, size, i, runs, expression);
+
+	// Always take the lowest first item, then refill or drop its run
+	while (size > 0 && result)
+	{
+		struct run* top = runs + heap[0];
+		output[used++] = top->buffer[top->position++];
+		if (used == block)
+		{
+			result = flushBlock(output, used, target, writer);
+			used = 0;
+		}
+		if (top->position == top->length && !runFill(top, block)) heap[0] = heap[--size];
+		if (size > 0) heapSiftDown(heap, size, 0, runs, expression);
+	}
+	if (result && used > 0) result = flushBlock(output, used, target, writer);
+
+	// Check that every run has been read entirely
+	for (i = 0; i < count; i++)
+	{
+		if (ferror(files[i])) result = FALSE;
+		free(runs[i].buffer);
+	}
+	free(runs);
+	free(heap);
+	free(output);
+	return result;
+}
+
+/* ============= Sort ============= */
+
+// Closes all the given temporary files, which are removed automatically
+static void closeRuns(FILE** files, int count)
+{
+	int i;
+	for (i = 0; i < count; i++) fclose(files[i]);
+}
+
+// Merges groups of runs until they can all be merged together at once
+static bool_t reduceRuns(FILE** files, int* count, size_t budget, comparation(*expression)(T, T))
+{
+	while (*count > MAX_WAYS)
+	{
+		int merged = 0, start;
+		for (start = 0; start < *count; start += MAX_WAYS)
+		{
+			int group = *count - start < MAX_WAYS ? *count - start : MAX_WAYS;
+			FILE* target = tmpfile();
+			bool_t result = target != NULL
+				&& mergeRuns(files + start, group, budget, target, NULL, expression);
+			closeRuns(files + start, group);
+			if (!result)
+			{
+				if (target != NULL) fclose(target);
+				closeRuns(files, merged);
+				closeRuns(files + start + group, *count - start - group);
+				*count = 0;
+				return FALSE;
+			}
+			files[merged++] = target;
+		}
+		*count = merged;
+	}
+	return TRUE;
+}
+
+// Writes the final header, then removes the output file if something went wrong
+static bool_t closeOutput(list_writer_t* writer, const char* path, bool_t result)
+{
+	if (!list_writer_close(writer)) result = FALSE;
+	if (!result) remove(path);
+	return result;
+}
+
+// ExternalOrderBy
+bool_t external_order_by(const char* input_file, const char* output_file,
+	comparation(*expression)(T, T), size_t memory_budget)
+{
+	if (input_file == NULL || output_file == NULL || expression == NULL) return FALSE;
+	list_reader_t reader = list_reader_open(input_file);
+	if (reader == NULL) return FALSE;
+	long long total = list_reader_count(reader);
+	size_t capacity = memory_budget / sizeof(T);
+	if (capacity < MIN_RUN) capacity = MIN_RUN;
+	if (capacity > INT_MAX) capacity = INT_MAX;
+	if ((long long)capacity > total) capacity = total > 0 ? (size_t)total : 1;
+	T* buffer = (T*)malloc(capacity * sizeof(T));
+	list_writer_t writer;
+	int len = 0;
+
+	// Simple case: the whole input fits in memory and it is sorted directly
+	if (total <= (long long)capacity)
+	{
+		if (total > 0) len = list_reader_read(reader, buffer, (int)capacity);
+		bool_t valid = list_reader_close(&reader) && len == total;
+		if (valid && len > 0) introsort(buffer, len, expression);
+		writer = valid ? list_writer_open(output_file) : NULL;
+		bool_t result = writer != NULL
+			&& closeOutput(&writer, output_file, list_writer_write(writer, buffer, len));
+		free(buffer);
+		return result;
+	}
+
+	// Sort each run in memory and spill it to a temporary file
+	int count = 0, allocated = 16;
+	FILE** files = (FILE**)malloc(allocated * sizeof(FILE*));
+	bool_t result = TRUE;
+	while ((len = list_reader_read(reader, buffer, (int)capacity)) > 0)
+	{
+		introsort(buffer, len, expression);
+		FILE* file = tmpfile();
+		if (file == NULL || fwrite(buffer, sizeof(T), len, file) != (size_t)len)
+		{
+			if (file != NULL) fclose(file);
+			result = FALSE;
+			break;
+		}
+		if (count == allocated)
+		{
+			allocated <<= 1;
+			files = (FILE**)realloc(files, allocated * sizeof(FILE*));
+		}
+		files[count++] = file;
+	}
+	free(buffer);
+
+	// The checksum of the input is only known once it has been read entirely
+	if (!list_reader_close(&reader) || len < 0) result = FALSE;
+
+	// Merge all the runs into the output file
+	if (result) result = reduceRuns(files, &count, memory_budget, expression);
+	if (result)
+	{
+		writer = list_writer_open(output_file);
+		result = writer != NULL && closeOutput(&writer, output_file,
+			mergeRuns(files, count, memory_budget, NULL, writer, expression));
+	}
+	closeRuns(files, count);
+	free(files);
+	return result;
+}
@@ -0,0 +1,38 @@
+#ifndef EXTERNAL_SORT_H
+#define EXTERNAL_SORT_H
+
+#include "..\list_t.h"
+#include <stddef.h>
+
+/* ---------------------------------------------------------------------
+*  ExternalOrderBy
+*  ---------------------------------------------------------------------
+*  Description:
+*    Sorts the items of a binary list_t file (see serialization.h) and
+*    writes them to another binary file, without loading the whole
+*    input in memory. The input is split in runs that fit inside the
+*    memory budget: each run is sorted with introsort and spilled to a
+*    temporary file, then all the runs are merged together with a heap
+*    that always returns the lowest of their first items.
+*    Returns FALSE if a parameter is NULL, if the input file is not valid
+*    or if a file can't be read or written. In that case the output file
+*    is removed.
+*  Example (assuming T is int):
+*    external_order_by("input.bin", "sorted.bin", comparator(a, b,
+*    {
+*        return a > b ? GREATER : a == b ? EQUAL : LOWER;
+*    }), 64 << 20);
+*  NOTE:
+*    The budget is only respected approximately: each run being merged
+*    always gets a buffer of at least a few KB. The input file is closed
+*    before the output file is created, so they can be the same file.
+*    The sort is not stable.
+*  Parameters:
+*    input_file ---> The path of the file to sort
+*    output_file ---> The path of the sorted file to create
+*    expression ---> Comparator lambda expression
+*    memory_budget ---> The maximum number of bytes used to buffer the items */
+bool_t external_order_by(const char* input_file, const char* output_file,
+	comparation(*expression)(T, T), size_t memory_budget);
+
+#endif
@@ -1,6 +1,5 @@
 #include "..\list_t.h"
 #include <stdlib.h>
-#include <time.h>
 
 /* ============= Misc ============= */
 
@@ -24,160 +23,156 @@ static int base10_log(int value)
 	return log;
 }
 
-/* ============================================================================
-*  Heapsort
-*  ========================================================================= */
-
-// Restores the heap properties of an array by moving down the first element
-static void sift_down(T* vector, int start, int end, comparation(*expression)(T, T))
-{
-	// Temp variables
-	int root = start, temp;
-
-	// Iterate while the root has at least one child
-	while ((temp = (root << 1) + 1) <= end)
-	{
-		// Store the first child and the item to swap
-		int child = temp;
-		int swap = root;
-
-		// If a child is greater than the root, swap the two items
-		if (expression(vector[swap], vector[child]) == LOWER) swap = child;
-		if ((child + 1 <= end) && (expression(vector[swap], vector[child + 1])) == LOWER)
-		{
-			swap = child + 1;
-		}
-		// If the root has the largest element, the soft down operation is concluded
-		if (swap == root) return;
-
-		// Perform the sift down and continue
-		swap_by_pointers(vector + root, vector + swap);
-		root = swap;
-	}
-}
-
-// Trasnforms a vector into a heap structure, in-place
-static void heapify(T* vector, int n, comparation(*expression)(T, T))
-{
-	int start = (n - 2) / 2;
-	while (start >= 0)
-	{
-		sift_down(vector, start, n - 1, expression);
-		start--;
-	}
-}
+// Initial state of the random generator used to pick the pivots
+#define RANDOM_SEED 2463534242u
 
-// In-place heapsort algorithm >> O(nlogn) as worst case
-static void heapsort(T* vector, int n, comparation(*expression)(T, T))
+// Returns the next number of a xorshift generator. Each sort call keeps its own
+// state, so that it doesn't use or change the global rand() sequence
+static inline unsigned int next_random(unsigned int* state)
 {
-	// Rearrange the target vector as a heap
-	heapify(vector, n, expression);
-
-	// Begin the actual sorting algorithm
-	int end = n - 1;
-	while (end > 0)
-	{
-		// Put the largest value in the first position
-		swap_by_pointers(vector + end, vector);
-
-		// Reduce the size of the heap
-		end--;
-
-		// Make sure the vector still respects the heap properties
-		sift_down(vector, 0, end, expression);
-	}
+	*state ^= *state << 13;
+	*state ^= *state >> 17;
+	*state ^= *state << 5;
+	return *state;
 }
 
 /* ============================================================================
-*  Insertion sort
+*  Sorting functions
 *  ========================================================================= */
 
-// Classic in-place insertion sort algorithm >> O(n^2)
-static void insertion_sort(T* vector, const size, comparation(*expression)(T, T))
-{
-	int i, j;
-	for (i = 0; i < size; i++)
-	{
-		for (j = i; j < size; j++)
-		{
-			if (expression(vector[j], vector[i]) == LOWER)
-			{
-				swap_by_pointers(vector + i, vector + j);
-			}
-		}
-	}
-}
-
-/* ============================================================================
-*  Quicksort
-*  ========================================================================= */
+#define MIN_QUICKSORT_SIZE 9
 
-// Partition function based on the Lomuto's Partitioning Algorithm
-static int partition(T* vector, int left, int right, comparation(*expression)(T, T))
-{
-	// Pick a random pivot index and select the pivot item
-	int pivot_index = left + (rand() % (right - left + 1));
-	T pivot = vector[pivot_index];
+// Defines the heapsort, insertion sort, quicksort partition and introsort functions
+// for a comparator type. The functions have the given suffix, PARAMS are the
+// comparator parameters, ARGS are the same parameters passed as arguments and
+// COMPARE(a, b) calls the comparator: this way each variant calls its comparator
+// directly, instead of checking which one to use for each comparison.
+#define DEFINE_INTROSORT(suffix, PARAMS, ARGS, COMPARE)                       \
+/* Restores the heap properties of an array by moving down the first element */ \
+static void sift_down##suffix(T* vector, int start, int end, PARAMS)          \
+{                                                                             \
+	int root = start, temp;                                                   \
+	while ((temp = (root << 1) + 1) <= end)                                   \
+	{                                                                         \
+		int child = temp;                                                     \
+		int swap = root;                                                      \
+		if (COMPARE(vector[swap], vector[child]) == LOWER) swap = child;      \
+		if ((child + 1 <= end) && (COMPARE(vector[swap], vector[child + 1])) == LOWER) \
+		{                                                                     \
+			swap = child + 1;                                                 \
+		}                                                                     \
+		if (swap == root) return;                                             \
+		swap_by_pointers(vector + root, vector + swap);                       \
+		root = swap;                                                          \
+	}                                                                         \
+}                                                                             \
+                                                                              \
+/* In-place heapsort algorithm >> O(nlogn) as worst case */                   \
+static void heapsort##suffix(T* vector, int n, PARAMS)                        \
+{                                                                             \
+	int start = (n - 2) / 2;                                                  \
+	while (start >= 0)                                                        \
+	{                                                                         \
+		sift_down##suffix(vector, start, n - 1, ARGS);                        \
+		start--;                                                              \
+	}                                                                         \
+	int end = n - 1;                                                          \
+	while (end > 0)                                                           \
+	{                                                                         \
+		swap_by_pointers(vector + end, vector);                               \
+		end--;                                                                \
+		sift_down##suffix(vector, 0, end, ARGS);                              \
+	}                                                                         \
+}                                                                             \
+                                                                              \
+/* Classic in-place insertion sort algorithm >> O(n^2) */                     \
+static void insertion_sort##suffix(T* vector, const int size, PARAMS)         \
+{                                                                             \
+	int i, j;                                                                 \
+	for (i = 0; i < size; i++)                                                \
+	{                                                                         \
+		for (j = i; j < size; j++)                                            \
+		{                                                                     \
+			if (COMPARE(vector[j], vector[i]) == LOWER)                       \
+			{                                                                 \
+				swap_by_pointers(vector + i, vector + j);                     \
+			}                                                                 \
+		}                                                                     \
+	}                                                                         \
+}                                                                             \
+                                                                              \
+/* Partition function based on the Lomuto's Partitioning Algorithm */         \
+static int partition##suffix(T* vector, int left, int right, PARAMS, unsigned int* state) \
+{                                                                             \
+	int pivot_index = left + (int)(next_random(state) % (unsigned int)(right - left + 1)); \
+	T pivot = vector[pivot_index];                                            \
+	swap_by_pointers(vector + pivot_index, vector + right);                   \
+	pivot_index = right;                                                      \
+	int i = left - 1, j;                                                      \
+	for (j = left; j < right; j++)                                            \
+	{                                                                         \
+		comparation result = COMPARE(vector[j], pivot);                       \
+		if (result == LOWER || result == EQUAL)                               \
+		{                                                                     \
+			i++;                                                              \
+			swap_by_pointers(vector + i, vector + j);                         \
+		}                                                                     \
+	}                                                                         \
+	swap_by_pointers(vector + i + 1, vector + pivot_index);                   \
+	return i + 1;                                                             \
+}                                                                             \
+                                                                              \
+/* Custom introsort algorithm that combines quicksort, heapsort and insertion sort */ \
+static void main_sort##suffix(T* vector, int left, int right, PARAMS, int depth, unsigned int* state) \
+{                                                                             \
+	if (left >= right) return;                                                \
+	int len = right - left + 1;                                               \
+	if (depth == 0) heapsort##suffix(vector + left, len, ARGS);               \
+	else if (len < MIN_QUICKSORT_SIZE)                                        \
+	{                                                                         \
+		insertion_sort##suffix(vector + left, len, ARGS);                     \
+	}                                                                         \
+	else                                                                      \
+	{                                                                         \
+		int part = partition##suffix(vector, left, right, ARGS, state);       \
+		main_sort##suffix(vector, left, part - 1, ARGS, depth - 1, state);    \
+		main_sort##suffix(vector, part + 1, right, ARGS, depth - 1, state);   \
+	}                                                                         \
+}
 
-	swap_by_pointers(vector + pivot_index, vector + right);
-	pivot_index = right;
-	int i = left - 1, j;
+// Standard comparator
+#define PLAIN_PARAMS comparation(*expression)(T, T)
+#define PLAIN_ARGS expression
+#define PLAIN_COMPARE(a, b) expression(a, b)
+DEFINE_INTROSORT(_plain, PLAIN_PARAMS, PLAIN_ARGS, PLAIN_COMPARE)
 
-	for (j = left; j < right; j++)
-	{
-		comparation result = expression(vector[j], pivot);
-		if (result == LOWER || result == EQUAL)
-		{
-			i++;
-			swap_by_pointers(vector + i, vector + j);
-		}
-	}
-	swap_by_pointers(vector + i + 1, vector + pivot_index);
-	return i + 1;
-}
+// Comparator with a context argument
+#define CTX_PARAMS comparation(*expression)(T, T, void*), void* ctx
+#define CTX_ARGS expression, ctx
+#define CTX_COMPARE(a, b) expression(a, b, ctx)
+DEFINE_INTROSORT(_ctx, CTX_PARAMS, CTX_ARGS, CTX_COMPARE)
 
 /* ============================================================================
 *  Custom introsort
 *  ========================================================================= */
 
-#define MIN_QUICKSORT_SIZE 9
-
-// Custom introsort algorithm that combines quicksort, heapsort and insertion sort
-static void main_sort(T* vector, int left, int right, comparation(*expression)(T, T), int depth)
-{
-	// Stop at the base case and calculate the length of the current vector
-	if (left >= right) return;
-	int len = right - left + 1;
-	
-	// If the maximum number of recursive calls has been reached, switch to heapsort
-	if (depth == 0) heapsort(vector + left, len, expression);
-	else
-	{
-		// Avoid the recursion and switch to insertion sort with small vectors
-		if (len < MIN_QUICKSORT_SIZE)
-		{
-			insertion_sort(vector + left, len, expression);
-		}
-		else
-		{
-			// Classic quicksort step
-			int part = partition(vector, left, right, expression);
-			main_sort(vector, left, part - 1, expression, depth - 1);
-			main_sort(vector, part + 1, right, expression, depth - 1);
-		}
-	}
-}
-
 // Sorts a vector using the custom introsort algorithm
 void introsort(T* vector, int len, comparation(*expression)(T, T))
 {
 	// Parameters check
 	if (vector == NULL || len <= 0 || expression == NULL) exit(EXIT_FAILURE);
 
-	// Randomize the rand seed and calculates the max recursion depth
-	srand((unsigned)time(NULL));
+	// Calculates the max recursion depth and starts the introsort
+	unsigned int state = RANDOM_SEED ^ (unsigned int)len;
 	int maxdepth = 2 * base10_log(len);
+	main_sort_plain(vector, 0, len - 1, expression, maxdepth, &state);
+}
 
-	// Starts the introsort
-	main_sort(vector, 0, len - 1, expression, maxdepth);
+// Sorts a vector using the custom introsort algorithm and a context comparator
+void introsort_ctx(T* vector, int len, comparation(*expression_ctx)(T, T, void*), void* ctx)
+{
+	if (vector == NULL || len <= 0 || expression_ctx == NULL) exit(EXIT_FAILURE);
+	unsigned int state = RANDOM_SEED ^ (unsigned int)len;
+	int maxdepth = 2 * base10_log(len);
+	main_sort_ctx(vector, 0, len - 1, expression_ctx, ctx, maxdepth, &state);
 }
\ No newline at end of file
@@ -10,10 +10,27 @@
 *    sub-array to sort is small enough. This algorithm has a worst case
 *    cost of O(nlogn) and it is faster than the heapsort algorithm,
 *    while using less memory than a quicksort algorithm.
+*  NOTE:
+*    The pivots are picked by a random generator that is local to each
+*    call, so the function doesn't use or change the rand() sequence and
+*    it can sort different vectors from different threads at once.
 *  Parameters:
 *    vector ---> The vector to sort
 *    len ---> The number of elements in the vector to sort
 *    expression ---> Comparator lambda expression (see the list_t.h file) */
 void introsort(T* vector, int len, comparation(*expression)(T, T));
 
+/* ---------------------------------------------------------------------
+*  IntrosortCtx
+*  ---------------------------------------------------------------------
+*  Description:
+*    Same as the Introsort function, but it uses a comparator that takes
+*    an additional context argument.
+*  Parameters:
+*    vector ---> The vector to sort
+*    len ---> The number of elements in the vector to sort
+*    expression_ctx ---> Comparator function with a context argument
+*    ctx ---> The context to pass to the comparator */
+void introsort_ctx(T* vector, int len, comparation(*expression_ctx)(T, T, void*), void* ctx);
+
 #endif
\ No newline at end of file
@@ -0,0 +1,362 @@
+#include "..\list_t.h"
+#include "serialization.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <limits.h>
+#include <stdint.h>
+#ifndef _WIN32
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#endif
+
+/* ============= Misc ============= */
+
+// "LIST" in little endian: a file written on a big endian machine has a different magic
+#define FILE_MAGIC 0x5453494Cu
+#define FILE_VERSION 1
+
+// Number of items copied from the list_t and written with a single call
+#define WRITE_BLOCK 65536
+
+// Size of the buffer of the output file
+#define FILE_BUFFER (1 << 20)
+
+// Header of a binary list_t file, 32 bytes long so that the items are aligned
+struct fileHeader
+{
+	uint32_t magic;
+	uint16_t version;
+	uint16_t typeSize;
+	uint64_t count;
+	uint64_t checksum;
+	uint64_t reserved;
+};
+
+// State of a Fletcher-like checksum, computed on 32 bit words when the size of T allows it
+struct checksum
+{
+	uint64_t low;
+	uint64_t high;
+};
+
+// Adds the given items to the checksum
+static void checksumUpdate(struct checksum* state, const T* items, size_t count)
+{
+	size_t bytes = count * sizeof(T), i;
+	const unsigned char* data = (const unsigned char*)items;
+	if (sizeof(T) % sizeof(uint32_t) == 0)
+	{
+		for (i = 0; i < bytes; i += sizeof(uint32_t))
+		{
+			uint32_t word;
+			memcpy(&word, data + i, sizeof(uint32_t));
+			state->low += word;
+			state->high += state->low;
+		}
+	}
+	else
+	{
+		for (i = 0; i < bytes; i++)
+		{
+			state->low += data[i];
+			state->high += state->low;
+		}
+	}
+}
+
+// Returns the final value of the checksum
+static inline uint64_t checksumValue(const struct checksum* state)
+{
+	return state->low ^ (state->high * 0x9E3779B97F4A7C15ull);
+}
+
+/* ============= Writer ============= */
+
+// Output file that is being written, along with the state of its header
+struct listWriter
+{
+	FILE* file;
+	char* buffer;
+	uint64_t count;
+	struct checksum checksum;
+	bool_t failed;
+};
+
+// ListWriterOpen
+list_writer_t list_writer_open(const char* path)
+{
+	if (path == NULL) return NULL;
+	FILE* file = fopen(path, "wb");
+	if (file == NULL) return NULL;
+
+	// Write an empty header, which is completed when the writer is closed
+	list_writer_t writer = (list_writer_t)calloc(1, sizeof(struct listWriter));
+	struct fileHeader header = { 0 };
+	writer->file = file;
+	writer->buffer = (char*)malloc(FILE_BUFFER);
+	setvbuf(file, writer->buffer, _IOFBF, FILE_BUFFER);
+	writer->failed = fwrite(&header, sizeof(header), 1, file) != 1;
+	return writer;
+}
+
+// ListWriterWrite
+bool_t list_writer_write(list_writer_t writer, const T* items, int count)
+{
+	if (writer == NULL || items == NULL || count < 0 || writer->failed) return FALSE;
+	checksumUpdate(&writer->checksum, items, count);
+	writer->count += count;
+	writer->failed = fwrite(items, sizeof(T), count, writer->file) != (size_t)count;
+	return !writer->failed;
+}
+
+// ListWriterClose
+bool_t list_writer_close(list_writer_t* writer)
+{
+	if (*writer == NULL) return FALSE;
+	list_writer_t target = *writer;
+	struct fileHeader header = { 0 };
+	header.magic = FILE_MAGIC;
+	header.version = FILE_VERSION;
+	header.typeSize = (uint16_t)sizeof(T);
+	header.count = target->count;
+	header.checksum = checksumValue(&target->checksum);
+	if (!target->failed)
+	{
+		target->failed = fseek(target->file, 0, SEEK_SET) != 0
+			|| fwrite(&header, sizeof(header), 1, target->file) != 1;
+	}
+	if (fclose(target->file) != 0) target->failed = TRUE;
+	bool_t result = !target->failed;
+	free(target->buffer);
+	free(target);
+	*writer = NULL;
+	return result;
+}
+
+// ListSave
+bool_t list_save(list_t list, const char* path)
+{
+	if (list == NULL) return FALSE;
+	list_writer_t writer = list_writer_open(path);
+	if (writer == NULL) return FALSE;
+	list_span_iterator_t iterator = get_span_iterator(list, NULL, WRITE_BLOCK);
+	const T* data;
+	int len;
+	while (next_span(iterator, &data, &len)) list_writer_write(writer, data, len);
+	destroy_span_iterator(&iterator);
+	return list_writer_close(&writer);
+}
+
+/* ============= Reader ============= */
+
+// Input file that is being read, along with the values from its header
+struct listReader
+{
+	FILE* file;
+	char* buffer;
+	uint64_t count;
+	uint64_t remaining;
+	uint64_t expected;
+	struct checksum checksum;
+	bool_t failed;
+};
+
+// Checks the fields of a header that don't depend on the length of the file
+static inline bool_t validFormat(const struct fileHeader* header)
+{
+	return header->magic == FILE_MAGIC && header->version == FILE_VERSION
+		&& header->typeSize == sizeof(T);
+}
+
+// ListReaderOpen
+list_reader_t list_reader_open(const char* path)
+{
+	if (path == NULL) return NULL;
+	FILE* file = fopen(path, "rb");
+	if (file == NULL) return NULL;
+	struct fileHeader header;
+	if (fread(&header, sizeof(header), 1, file) != 1 || !validFormat(&header))
+	{
+		fclose(file);
+		return NULL;
+	}
+	list_reader_t reader = (list_reader_t)calloc(1, sizeof(struct listReader));
+	reader->file = file;
+	reader->buffer = (char*)malloc(FILE_BUFFER);
+	setvbuf(file, reader->buffer, _IOFBF, FILE_BUFFER);
+	reader->count = header.count;
+	reader->remaining = header.count;
+	reader->expected = header.checksum;
+	return reader;
+}
+
+// ListReaderCount
+long long list_reader_count(list_reader_t reader)
+{
+	return reader == NULL ? -1 : (long long)reader->count;
+}
+
+// ListReaderRead
+int list_reader_read(list_reader_t reader, T* buffer, int capacity)
+{
+	if (reader == NULL || buffer == NULL || capacity <= 0 || reader->failed) return -1;
+	if (reader->remaining == 0) return 0;
+	if ((uint64_t)capacity > reader->remaining) capacity = (int)reader->remaining;
+	if (fread(buffer, sizeof(T), capacity, reader->file) != (size_t)capacity)
+	{
+		reader->failed = TRUE;
+		return -1;
+	}
+	checksumUpdate(&reader->checksum, buffer, capacity);
+	reader->remaining -= capacity;
+	return capacity;
+}
+
+// ListReaderClose
+bool_t list_reader_close(list_reader_t* reader)
+{
+	if (*reader == NULL) return FALSE;
+	list_reader_t target = *reader;
+	bool_t result = !target->failed && target->remaining == 0
+		&& checksumValue(&target->checksum) == target->expected;
+	fclose(target->file);
+	free(target->buffer);
+	free(target);
+	*reader = NULL;
+	return result;
+}
+
+/* ============= Mapping ============= */
+
+// A binary file mapped into memory (or read inside a buffer) and its items
+struct listMapping
+{
+	void* base;
+	size_t length;
+	const T* data;
+	int count;
+};
+
+// Checks the header of a file with the given total length
+static bool_t validHeader(const struct fileHeader* header, size_t length)
+{
+	if (!validFormat(header) || header->count > INT_MAX) return FALSE;
+	return length == sizeof(struct fileHeader) + header->count * sizeof(T);
+}
+
+// Maps the whole file in read-only mode, returns NULL on failure
+static void* mapFile(const char* path, size_t* length)
+{
+#ifndef _WIN32
+	int descriptor = open(path, O_RDONLY);
+	if (descriptor < 0) return NULL;
+	struct stat info;
+	void* base = NULL;
+	if (fstat(descriptor, &info) == 0 && (size_t)info.st_size >= sizeof(struct fileHeader))
+	{
+		*length = (size_t)info.st_size;
+		base = mmap(NULL, *length, PROT_READ, MAP_PRIVATE, descriptor, 0);
+		if (base == MAP_FAILED) base = NULL;
+	}
+	close(descriptor);
+	return base;
+#else
+	FILE* file = fopen(path, "rb");
+	if (file == NULL) return NULL;
+	void* base = NULL;
+	if (fseek(file, 0, SEEK_END) == 0)
+	{
+		long size = ftell(file);
+		if (size >= (long)sizeof(struct fileHeader) && fseek(file, 0, SEEK_SET) == 0)
+		{
+			*length = (size_t)size;
+			base = malloc(*length);
+			if (fread(base, 1, *length, file) != *length)
+			{
+				free(base);
+				base = NULL;
+			}
+		}
+	}
+	fclose(file);
+	return base;
+#endif
+}
+
+// Releases the memory returned by mapFile
+static void unmapFile(void* base, size_t length)
+{
+#ifndef _WIN32
+	munmap(base, length);
+#else
+	free(base);
+#endif
+}
+
+// ListMap
+list_mapping_t list_map(const char* path)
+{
+	if (path == NULL) return NULL;
+	size_t length;
+	void* base = mapFile(path, &length);
+	if (base == NULL) return NULL;
+
+	// Check the header and the items before exposing them
+	struct fileHeader header;
+	memcpy(&header, base, sizeof(header));
+	const T* data = (const T*)((char*)base + sizeof(header));
+	bool_t valid = validHeader(&header, length);
+	if (valid)
+	{
+		struct checksum checksum = { 0, 0 };
+		checksumUpdate(&checksum, data, (size_t)header.count);
+		valid = checksumValue(&checksum) == header.checksum;
+	}
+	if (!valid)
+	{
+		unmapFile(base, length);
+		return NULL;
+	}
+	list_mapping_t mapping = (list_mapping_t)malloc(sizeof(struct listMapping));
+	mapping->base = base;
+	mapping->length = length;
+	mapping->data = data;
+	mapping->count = (int)header.count;
+	return mapping;
+}
+
+// MappingData
+const T* mapping_data(list_mapping_t mapping, int* count)
+{
+	if (mapping == NULL || mapping->count == 0)
+	{
+		if (count != NULL) *count = 0;
+		return NULL;
+	}
+	if (count != NULL) *count = mapping->count;
+	return mapping->data;
+}
+
+// ListUnmap
+bool_t list_unmap(list_mapping_t* mapping)
+{
+	if (*mapping == NULL) return FALSE;
+	unmapFile((*mapping)->base, (*mapping)->length);
+	free(*mapping);
+	*mapping = NULL;
+	return TRUE;
+}
+
+// ListLoad
+list_t list_load(const char* path)
+{
+	list_mapping_t mapping = list_map(path);
+	if (mapping == NULL) return NULL;
+	list_t list = create();
+	if (mapping->count > 0) add_range(list, mapping->data, mapping->count);
+	list_unmap(&mapping);
+	return list;
+}
@@ -0,0 +1,181 @@
+#ifndef SERIALIZATION_H
+#define SERIALIZATION_H
+
+#include "..\list_t.h"
+
+/* =====================================================================
+*  Binary files
+*  =====================================================================
+*  Description:
+*    Functions that save a list_t to a binary file and load it back.
+*    The file starts with a 32 bytes header (a magic number that also
+*    identifies the byte order, the format version, the size of T, the
+*    number of items and a checksum of the items), followed by all the
+*    items stored one after the other, exactly as they are in memory.
+*  NOTE:
+*    The items are written as raw bytes, so a file can only be loaded by
+*    a program that uses the same T on a machine with the same byte
+*    order, and T must not contain pointers.
+*    A list_t is made of linked nodes, so it can't point directly to the
+*    mapped file: list_map returns a read-only array instead, that can be
+*    used with no copies at all, while list_load copies the items inside
+*    a new list_t with a single allocation. */
+
+typedef struct listMapping* list_mapping_t;
+typedef struct listWriter* list_writer_t;
+typedef struct listReader* list_reader_t;
+
+/* ---------------------------------------------------------------------
+*  ListSave
+*  ---------------------------------------------------------------------
+*  Description:
+*    Writes the list_t to the given file, overwriting it. The items are
+*    copied in large blocks and written with a single call for each
+*    block. Returns FALSE if the list_t or the path are NULL, or if the
+*    file can't be written.
+*  Parameters:
+*    list ---> The list_t to save
+*    path ---> The path of the target file */
+bool_t list_save(list_t list, const char* path);
+
+/* ---------------------------------------------------------------------
+*  ListLoad
+*  ---------------------------------------------------------------------
+*  Description:
+*    Creates a new list_t with the items inside the given file.
+*    Returns NULL if the file can't be read, if it was written with a
+*    different T or with a different format, or if the checksum of the
+*    items is not valid.
+*  Parameters:
+*    path ---> The path of the file to load */
+list_t list_load(const char* path);
+
+/* ---------------------------------------------------------------------
+*  ListMap
+*  ---------------------------------------------------------------------
+*  Description:
+*    Maps the given file into memory and returns a read-only mapping
+*    that exposes its items as an array, without copying them.
+*    The file is checked just like with list_load, and NULL is returned
+*    if it is not valid. On the systems without mmap, the file is read
+*    inside a buffer with a single call.
+*  Parameters:
+*    path ---> The path of the file to map */
+list_mapping_t list_map(const char* path);
+
+/* ---------------------------------------------------------------------
+*  MappingData
+*  ---------------------------------------------------------------------
+*  Description:
+*    Returns the items of the mapping and assigns their number to count.
+*    The array must not be modified and it is valid until list_unmap is
+*    called. Returns NULL and assigns 0 to count if the mapping is NULL
+*    or empty, so the loop in the example is skipped. The count can be
+*    NULL if it is not needed.
+*  Example (assuming T is int):
+*    int count, i, total = 0;
+*    const int* items = mapping_data(mapping, &count);
+*    for (i = 0; i < count; i++) total += items[i];
+*  Parameters:
+*    mapping ---> The input mapping
+*    count ---> Pointer to an int to store the number of items */
+const T* mapping_data(list_mapping_t mapping, int* count);
+
+/* ---------------------------------------------------------------------
+*  ListUnmap
+*  ---------------------------------------------------------------------
+*  Description:
+*    Unmaps the file, deallocates the mapping and sets it to NULL.
+*    It returns FALSE if the mapping was already NULL.
+*  Parameters:
+*    mapping ---> A pointer to the target mapping */
+bool_t list_unmap(list_mapping_t* mapping);
+
+/* =====================================================================
+*  Streaming
+*  =====================================================================
+*  Description:
+*    Functions that write or read a binary file a block at a time, so
+*    that the number of items is not limited by the available memory
+*    or by the maximum length of a list_t. */
+
+/* ---------------------------------------------------------------------
+*  ListWriterOpen
+*  ---------------------------------------------------------------------
+*  Description:
+*    Creates the given file and returns a writer for it, or NULL if the
+*    file can't be created. The header is completed by list_writer_close.
+*  Parameters:
+*    path ---> The path of the target file */
+list_writer_t list_writer_open(const char* path);
+
+/* ---------------------------------------------------------------------
+*  ListWriterWrite
+*  ---------------------------------------------------------------------
+*  Description:
+*    Appends the given items to the file. Returns FALSE if the writer or
+*    the items are NULL, or if the file can't be written.
+*  Parameters:
+*    writer ---> The target writer
+*    items ---> The items to write
+*    count ---> The number of items to write */
+bool_t list_writer_write(list_writer_t writer, const T* items, int count);
+
+/* ---------------------------------------------------------------------
+*  ListWriterClose
+*  ---------------------------------------------------------------------
+*  Description:
+*    Writes the final header, closes the file, deallocates the writer
+*    and sets it to NULL. Returns FALSE if the writer was already NULL
+*    or if any write has failed.
+*  Parameters:
+*    writer ---> A pointer to the target writer */
+bool_t list_writer_close(list_writer_t* writer);
+
+/* ---------------------------------------------------------------------
+*  ListReaderOpen
+*  ---------------------------------------------------------------------
+*  Description:
+*    Opens the given file and returns a reader for it, or NULL if the
+*    file can't be read or if it was written with a different T or with
+*    a different format.
+*  Parameters:
+*    path ---> The path of the file to read */
+list_reader_t list_reader_open(const char* path);
+
+/* ---------------------------------------------------------------------
+*  ListReaderCount
+*  ---------------------------------------------------------------------
+*  Description:
+*    Returns the total number of items inside the file, or -1 if the
+*    reader is NULL.
+*  Parameters:
+*    reader ---> The input reader */
+long long list_reader_count(list_reader_t reader);
+
+/* ---------------------------------------------------------------------
+*  ListReaderRead
+*  ---------------------------------------------------------------------
+*  Description:
+*    Copies the next items of the file inside the buffer and returns
+*    their number, which is 0 when there are no items left.
+*    Returns -1 if the reader or the buffer are NULL, if the capacity
+*    is not valid or if the file can't be read.
+*  Parameters:
+*    reader ---> The input reader
+*    buffer ---> The buffer to store the items
+*    capacity ---> The maximum number of items to read */
+int list_reader_read(list_reader_t reader, T* buffer, int capacity);
+
+/* ---------------------------------------------------------------------
+*  ListReaderClose
+*  ---------------------------------------------------------------------
+*  Description:
+*    Closes the file, deallocates the reader and sets it to NULL.
+*    Returns TRUE only if all the items have been read and their
+*    checksum is valid.
+*  Parameters:
+*    reader ---> A pointer to the target reader */
+bool_t list_reader_close(list_reader_t* reader);
+
+#endif
@@ -9,6 +9,8 @@
 #include <stdlib.h>
 #include <limits.h>
 #include <time.h>
+#include <stddef.h>
+#include <string.h>
 #include "list_t.h"
 #include "Introsort\introsort.h"
 
@@ -20,12 +22,34 @@ struct listElem
 	struct listElem* previous;
 	T info;
 	struct listElem* next;
+	struct nodeBlock* block;
 };
 
 // Type declarations for the list_t node and a node pointer
 typedef struct listElem listNode;
 typedef listNode* nodePointer;
 
+/* ---------------------------------------------------------------------
+*  nodeBlock
+*  ---------------------------------------------------------------------
+*  Description:
+*    A group of nodes allocated with a single malloc call by the bulk
+*    construction functions. Each node of the block points to it, and
+*    the block keeps the number of nodes that are still in use, so that
+*    it is deallocated as a unit when the last one is released.
+*    Nodes allocated one at a time have a NULL block pointer.
+*  NOTE:
+*    The block pointer makes each node one pointer larger, but it lets a
+*    node find its block in O(1) after it has been spliced into another
+*    list_t, which a list of the blocks of each list_t could not do. As
+*    a result, one surviving node keeps its whole block allocated, until
+*    list_compact moves it to a new block. */
+struct nodeBlock
+{
+	int live;
+	listNode nodes[];
+};
+
 /* ---------------------------------------------------------------------
 *  listBase
 *  ---------------------------------------------------------------------
@@ -34,768 +58,2753 @@ typedef listNode* nodePointer;
 *    to the last node (so that functions like get_first(), get_last() and
 *    add() have a O(1) cost), the current length of the list (this way
 *    getting the size has a O(1) cost as well) and a sync variable used
-*    to check if a list iterator is valid for the current list. */
+*    to check if a list iterator is valid for the current list.
+*    The next three fields store the state of an incremental compaction
+*    (see list_compact_step): the next node to compact, the number of
+*    nodes compacted so far (0 if no compaction is in progress, -1 if the
+*    last one has reached the end) and the sync value of the list when
+*    the last compaction ended.
+*    The next five point to the optional hash index, Bloom filter,
+*    incremental aggregates, range queries tree and views of the list.
+*    If the observers are enabled, the last fields store the observers
+*    of the list and the last node an event was sent for, along with its
+*    index, used to find the index of the following nodes faster. */
 struct listBase
 {
 	nodePointer head;
 	nodePointer tail;
 	int length;
 	unsigned int sync;
+	nodePointer compactCursor;
+	int compactPosition;
+	unsigned int compactSync;
+	struct hashIndex* index;
+	struct bloomFilter* filter;
+	struct listAggregate* aggregates;
+	struct rangeTree* ranges;
+	struct listView* views;
+#ifdef LIST_T_OBSERVERS
+	struct listObserver* observers;
+	nodePointer observedNode;
+	int observedIndex;
+#endif
 };
 
+// NOTE: the listIterator struct is declared inside the list_t.h file, so
+// that an iterator can be allocated on the stack (see iterator_init).
+
+// Type declaration for the list_t iterator
+typedef struct listIterator iteratorInstance;
+
 /* ---------------------------------------------------------------------
-*  listIterator
+*  listSpanIterator
 *  ---------------------------------------------------------------------
 *  Description:
-*    An iterator for a list_t list. It stores a pointer to the target node,
-*    one to the target list, the current position inside the list, a sync
-*    variable that checks if the iterator is still valid and a started
-*    variable used to calculate the next node to return. */
-struct listIterator
+*    An iterator that returns the items of a list_t in contiguous blocks.
+*    It stores a pointer to the next node to read, one to the target
+*    list, the sync variable, the buffer used to store each block with
+*    its capacity and a flag that tells if the buffer has to be freed
+*    when the iterator is destroyed. */
+struct listSpanIterator
 {
 	nodePointer pointer;
 	list_t list;
-	int position;
 	unsigned int sync;
-	bool_t started;
+	T* buffer;
+	int capacity;
+	bool_t ownsBuffer;
 };
 
-// Type declaration for the list_t iterator
-typedef struct listIterator iteratorInstance;
-
 /* ============================================================================
-*  Generic functions
+*  Nodes allocation
 *  ========================================================================= */
 
-// Create
-list_t create()
+// Allocates a single node
+static inline nodePointer allocateNode()
 {
-	list_t outList = (list_t)malloc(sizeof(struct listBase));
-	outList->head = NULL;
-	outList->tail = NULL;
-	outList->length = 0;
-	outList->sync = 0;
-	return outList;
+	nodePointer node = (nodePointer)malloc(sizeof(listNode));
+	node->block = NULL;
+	return node;
 }
 
-#define GET_ITERATOR(target) nodePointer iterator = target
-#define GET_HEAD_ITERATOR GET_ITERATOR(list->head)
-#define GET_TAIL_ITERATOR GET_ITERATOR(list->tail)
-#define MOVE_NEXT iterator = iterator->next
-#define MOVE_NEXT_W_INDEX(index) MOVE_NEXT; index++
-#define MOVE_BACK iterator = iterator->previous
-#define MOVE_BACK_W_INDEX(index) MOVE_BACK; index--
-#define SYNC_PLUS list->sync++;
+// Releases a node, deallocating its block if it was the last one in use
+static inline void freeNode(nodePointer node)
+{
+	if (node->block == NULL) free(node);
+	else if (--node->block->live == 0) free(node->block);
+}
 
-#define CLEAR_LIST   \
-list->length = 0;    \
-list->head = NULL;   \
-list->tail = NULL
+/* ============================================================================
+*  Hash index
+*  ========================================================================= */
 
-// Clear
-bool_t clear(list_t list)
+// Single entry inside a bucket of the hash index
+struct hashEntry
 {
-	if (list == NULL) return FALSE;
-	if (list->length == 0) return TRUE;
-	SYNC_PLUS;
-	if (list->length == 1)
+	nodePointer node;
+	struct hashEntry* next;
+};
+
+/* ---------------------------------------------------------------------
+*  hashIndex
+*  ---------------------------------------------------------------------
+*  Description:
+*    A hash table that maps each item of a list_t to its node. It stores
+*    the hash function, the buckets array with its mask (the number of
+*    buckets is always a power of 2, minus 1), the number of entries and
+*    a list of unused entries, so that they can be reused instead of
+*    being allocated each time an item is added to the list_t. */
+struct hashIndex
+{
+	unsigned int(*hash)(T);
+	struct hashEntry** buckets;
+	unsigned int mask;
+	int count;
+	struct hashEntry* recycled;
+};
+
+#define INITIAL_BUCKETS 16
+#define BUCKET_OF(index, item) (index->buckets + (index->hash(item) & index->mask))
+
+// Doubles the number of buckets and moves the entries inside the new ones
+static void hashIndexGrow(struct hashIndex* index)
+{
+	unsigned int oldSize = index->mask + 1, i;
+	struct hashEntry** oldBuckets = index->buckets;
+	index->mask = (oldSize << 1) - 1;
+	index->buckets = (struct hashEntry**)calloc(oldSize << 1, sizeof(struct hashEntry*));
+	for (i = 0; i < oldSize; i++)
 	{
-		free(list->head);
-		CLEAR_LIST;
-		return TRUE;
+		struct hashEntry* entry = oldBuckets[i];
+		while (entry != NULL)
+		{
+			struct hashEntry* next = entry->next;
+			struct hashEntry** bucket = BUCKET_OF(index, entry->node->info);
+			entry->next = *bucket;
+			*bucket = entry;
+			entry = next;
+		}
 	}
-	GET_ITERATOR(list->head->next);
-	while (TRUE)
+	free(oldBuckets);
+}
+
+// Adds the given node to the hash index
+static void hashIndexInsert(struct hashIndex* index, nodePointer node)
+{
+	if ((unsigned int)index->count > index->mask) hashIndexGrow(index);
+	struct hashEntry* entry = index->recycled;
+	if (entry != NULL) index->recycled = entry->next;
+	else entry = (struct hashEntry*)malloc(sizeof(struct hashEntry));
+	struct hashEntry** bucket = BUCKET_OF(index, node->info);
+	entry->node = node;
+	entry->next = *bucket;
+	*bucket = entry;
+	index->count++;
+}
+
+// Removes the given node from the hash index, the item is the one used to insert it
+static void hashIndexRemove(struct hashIndex* index, nodePointer node, const T item)
+{
+	struct hashEntry** link = BUCKET_OF(index, item);
+	while (*link != NULL)
 	{
-		free(iterator->previous);
-		if (iterator->next == NULL)
+		struct hashEntry* entry = *link;
+		if (entry->node == node)
 		{
-			free(iterator);
-			break;
+			*link = entry->next;
+			entry->next = index->recycled;
+			index->recycled = entry;
+			index->count--;
+			return;
 		}
-		MOVE_NEXT;
+		link = &entry->next;
 	}
-	CLEAR_LIST;
-	return TRUE;
 }
 
-// Destroy
-bool_t destroy(list_t* list)
+// Replaces the old node with the new one, which has the same item
+static void hashIndexMove(struct hashIndex* index, nodePointer old, nodePointer node)
 {
-	if (clear(*list))
+	struct hashEntry* entry = *BUCKET_OF(index, node->info);
+	while (entry != NULL)
 	{
-		free(*list);
-		*list = NULL;
-		return TRUE;
+		if (entry->node == old)
+		{
+			entry->node = node;
+			return;
+		}
+		entry = entry->next;
 	}
-	return FALSE;
 }
 
-#define ASSIGN_IF_NOT_NULL(value)    \
-if (result != NULL) *result = value
-
-// DestroySequence
-void destroy_sequence(bool_t* result, list_t** pending)
+// Returns a node with the given item, or NULL. If matches is not NULL, it is set to
+// the number of nodes with the same item, counting up to 2
+static nodePointer hashIndexFind(struct hashIndex* index, const T item, int* matches)
 {
-	if (pending == NULL)
+	nodePointer found = NULL;
+	int total = 0;
+	struct hashEntry* entry = *BUCKET_OF(index, item);
+	while (entry != NULL)
 	{
-		ASSIGN_IF_NOT_NULL(FALSE);
-		return;
+		if (entry->node->info == item)
+		{
+			if (matches == NULL) return entry->node;
+			if (++total == 2) break;
+			found = entry->node;
+		}
+		entry = entry->next;
 	}
-	if (*pending == NULL)
+	if (matches != NULL) *matches = total;
+	return found;
+}
+
+// Removes all the entries from the hash index
+static void hashIndexReset(struct hashIndex* index)
+{
+	unsigned int i;
+	for (i = 0; i <= index->mask; i++)
 	{
-		ASSIGN_IF_NOT_NULL(FALSE);
-		return;
+		struct hashEntry* entry = index->buckets[i];
+		while (entry != NULL)
+		{
+			struct hashEntry* next = entry->next;
+			entry->next = index->recycled;
+			index->recycled = entry;
+			entry = next;
+		}
+		index->buckets[i] = NULL;
 	}
-	bool_t destroyed = FALSE;
-	while (*pending)
+	index->count = 0;
+}
+
+// Deallocates the hash index and all its entries
+static void hashIndexFree(struct hashIndex* index)
+{
+	hashIndexReset(index);
+	while (index->recycled != NULL)
 	{
-		destroy(*pending);
-		destroyed = TRUE;
-		pending++;
+		struct hashEntry* next = index->recycled->next;
+		free(index->recycled);
+		index->recycled = next;
 	}
-	ASSIGN_IF_NOT_NULL(destroyed);
+	free(index->buckets);
+	free(index);
 }
 
-// Copy
-list_t copy(const list_t source)
+/* ============================================================================
+*  Bloom filter
+*  ========================================================================= */
+
+/* ---------------------------------------------------------------------
+*  bloomFilter
+*  ---------------------------------------------------------------------
+*  Description:
+*    A Bloom filter that stores the items added to a list_t. It has the
+*    hash function, the bits array with its mask (the number of bits is
+*    always a power of 2, minus 1), the number of bits to set for each
+*    item, the requested false positive rate, the number of items the
+*    filter was sized for and the number of items added to the filter
+*    since it was last built. The removed items are never cleared from
+*    the bits array, so the filter has to be rebuilt to forget them. */
+struct bloomFilter
 {
-	if (source == NULL) return NULL;
-	list_t outList = create();
-	if (source->length == 0) return outList;
-	GET_ITERATOR(source->head);
-	while (iterator != NULL)
+	unsigned int(*hash)(T);
+	unsigned int* bits;
+	unsigned int mask;
+	int hashes;
+	float rate;
+	int capacity;
+	int count;
+};
+
+#define BITS_PER_WORD (sizeof(unsigned int) * CHAR_BIT)
+#define DEFAULT_BLOOM_CAPACITY 1024
+
+// Largest number of bits, the highest power of 2 the unsigned int mask can address
+#define MAX_BLOOM_BITS (1u << 31)
+
+// Second hash used to get the position of each bit with double hashing
+#define BLOOM_STEP(first) (((first >> 16) ^ first) * 0x45d9f3bu | 1u)
+
+// Allocates the bits array for the given capacity and false positive rate,
+// returns FALSE and leaves the filter unchanged if it can't be allocated
+static bool_t bloomFilterSize(struct bloomFilter* filter, int capacity)
+{
+	// Each hash halves the rate, and the optimal number of bits for
+	// each item is about 1.44 times the number of hashes
+	int hashes = 0;
+	float rate = filter->rate;
+	while (rate < 1 && hashes < 16)
 	{
-		add(iterator->info, outList);
-		MOVE_NEXT;
+		rate *= 2;
+		hashes++;
 	}
-	return outList;
+	if (hashes == 0) hashes = 1;
+	unsigned long long wanted = (unsigned long long)((double)capacity * hashes * 1.4427);
+	unsigned int total = BITS_PER_WORD;
+	if (wanted > MAX_BLOOM_BITS) wanted = MAX_BLOOM_BITS;
+	while (total < wanted) total <<= 1;
+	unsigned int* bits = (unsigned int*)calloc(total / BITS_PER_WORD, sizeof(unsigned int));
+	if (bits == NULL) return FALSE;
+	free(filter->bits);
+	filter->bits = bits;
+	filter->mask = total - 1;
+	filter->hashes = hashes;
+	filter->capacity = capacity;
+	filter->count = 0;
+	return TRUE;
 }
 
-// Create random
-list_t create_random(int length, int min, int max)
+// Sets the bits of the given item
+static void bloomFilterAdd(struct bloomFilter* filter, const T item)
 {
-	if (min >= max) return NULL;
-	if (length == 0) return create();
-	list_t outList = create();
-	srand((unsigned)time(NULL));
-	while (length != 0)
+	unsigned int position = filter->hash(item), step = BLOOM_STEP(position);
+	int i;
+	for (i = 0; i < filter->hashes; i++)
 	{
-		add((T)((rand() % (max - min)) + min), outList);
-		length--;
+		unsigned int bit = position & filter->mask;
+		filter->bits[bit / BITS_PER_WORD] |= 1u << (bit % BITS_PER_WORD);
+		position += step;
 	}
-	return outList;
+	filter->count++;
 }
 
-// CreateFrom
-list_t create_from(T* array, int size)
+// Returns FALSE if the item has never been added to the filter
+static bool_t bloomFilterMayContain(struct bloomFilter* filter, const T item)
 {
-	if (array == NULL || size <= 0) return NULL;
-	list_t outList = create();
+	unsigned int position = filter->hash(item), step = BLOOM_STEP(position);
 	int i;
-	for (i = 0; i < size; i++)
+	for (i = 0; i < filter->hashes; i++)
 	{
-		add(array[i], outList);
+		unsigned int bit = position & filter->mask;
+		if (!(filter->bits[bit / BITS_PER_WORD] & (1u << (bit % BITS_PER_WORD)))) return FALSE;
+		position += step;
 	}
-	return outList;
+	return TRUE;
 }
 
-// ToArray
-T* to_array(list_t list, int* size)
+// Clears all the bits of the filter
+static void bloomFilterReset(struct bloomFilter* filter)
 {
-	if (list == NULL || list->length == 0)
+	memset(filter->bits, 0, (filter->mask / BITS_PER_WORD + 1) * sizeof(unsigned int));
+	filter->count = 0;
+}
+
+// Sizes the filter for the current length of the list_t and adds all its items
+static void bloomFilterBuild(list_t list, int capacity)
+{
+	struct bloomFilter* filter = list->filter;
+	if (capacity < list->length) capacity = list->length;
+	if (capacity == filter->capacity || !bloomFilterSize(filter, capacity))
 	{
-		*size = -1;
-		return NULL;
+		// If a larger array can't be allocated the current one is reused,
+		// and the filter will try to grow again once the capacity doubles
+		filter->capacity = capacity;
+		bloomFilterReset(filter);
 	}
-	*size = list->length;
-	T* array = (T*)malloc(sizeof(T) * (*size));
-	int i = 0;
-	GET_HEAD_ITERATOR;
+	nodePointer iterator = list->head;
 	while (iterator != NULL)
 	{
-		array[i] = iterator->info;
-		i++;
-		MOVE_NEXT;
+		bloomFilterAdd(filter, iterator->info);
+		iterator = iterator->next;
 	}
-	return array;
 }
 
-#define CHECK_EMPTY(list) list == NULL || list->length == 0
-#define NULL_IF_EMPTY(list) if (CHECK_EMPTY(list)) return NULL
-#define RETURN_IF_EMPTY(list, value) if (CHECK_EMPTY(list)) return value
-
-// IsEmpty
-bool_t is_empty(list_t list)
+// Adds an item to the filter of the list_t, doubling its size when it is full
+static void bloomFilterInsert(list_t list, const T item)
 {
-	return CHECK_EMPTY(list);
+	struct bloomFilter* filter = list->filter;
+	if (filter->count >= filter->capacity && filter->capacity <= INT_MAX / 2)
+	{
+		bloomFilterBuild(list, filter->capacity * 2);
+	}
+	bloomFilterAdd(filter, item);
 }
 
-// IsElement
-bool_t is_element(const T item, list_t list)
+// Deallocates the Bloom filter
+static void bloomFilterFree(struct bloomFilter* filter)
 {
-	RETURN_IF_EMPTY(list, FALSE);
-	GET_HEAD_ITERATOR;
-	while (iterator != NULL)
-	{
-		if (iterator->info == item) return TRUE;
-		MOVE_NEXT;
-	}
-	return FALSE;
+	free(filter->bits);
+	free(filter);
 }
 
-// Inline function used inside the get_first and peek functions
-static inline bool_t GetFirst(list_t list, T* result)
+/* ============================================================================
+*  Incremental aggregates
+*  ========================================================================= */
+
+/* ---------------------------------------------------------------------
+*  lazyHeap
+*  ---------------------------------------------------------------------
+*  Description:
+*    A binary heap of int values that supports the removal of any value.
+*    The removed values are pushed inside a second heap with the same
+*    order, and both the tops are popped while they are equal: this way
+*    the top of the first heap is always a value that was not removed.
+*    When the removed values are too many, both the heaps are purged. */
+struct lazyHeap
 {
-	RETURN_IF_EMPTY(list, FALSE);
-	*result = list->head->info;
-	return TRUE;
+	int* items;
+	int count;
+	int capacity;
+	int* removed;
+	int removedCount;
+	int removedCapacity;
+	bool_t max;
+};
+
+#define HEAP_BEFORE(max, a, b) ((max) ? (a) > (b) : (a) < (b))
+#define INITIAL_HEAP_CAPACITY 16
+
+// Adds a value to an array used as a heap, growing the array if needed
+static void heapPush(bool_t max, int** items, int* count, int* capacity, int value)
+{
+	if (*count == *capacity)
+	{
+		*capacity = *capacity == 0 ? INITIAL_HEAP_CAPACITY : *capacity * 2;
+		*items = (int*)realloc(*items, sizeof(int) * (*capacity));
+	}
+	int* heap = *items;
+	int i = (*count)++;
+	while (i > 0 && HEAP_BEFORE(max, value, heap[(i - 1) / 2]))
+	{
+		heap[i] = heap[(i - 1) / 2];
+		i = (i - 1) / 2;
+	}
+	heap[i] = value;
 }
 
-// GetFirst
-bool_t get_first(list_t list, T* result)
+// Removes the top value from an array used as a heap
+static void heapPop(bool_t max, int* heap, int* count)
 {
-	return GetFirst(list, result);
+	int value = heap[--(*count)], i = 0, child;
+	while ((child = 2 * i + 1) < *count)
+	{
+		if (child + 1 < *count && HEAP_BEFORE(max, heap[child + 1], heap[child])) child++;
+		if (!HEAP_BEFORE(max, heap[child], value)) break;
+		heap[i] = heap[child];
+		i = child;
+	}
+	heap[i] = value;
 }
 
-// GetLast
-bool_t get_last(list_t list, T* result)
+// Comparison function used to sort the heaps with qsort
+static int compareInts(const void* a, const void* b)
 {
-	RETURN_IF_EMPTY(list, FALSE);
-	*result = list->tail->info;
-	return TRUE;
+	int first = *(const int*)a, second = *(const int*)b;
+	return (first > second) - (first < second);
 }
 
-// Get
-bool_t get(list_t list, int index, T* result)
+// Deletes the removed values from the heap. Both arrays are sorted and merged,
+// a sorted array is already a valid heap (in descending order for a max heap)
+static void lazyHeapPurge(struct lazyHeap* heap)
 {
-	if (index < 0 || index >= list->length) return FALSE;
-	bool_t fromHead = index <= list->length / 2;
-	if (fromHead)
+	qsort(heap->items, heap->count, sizeof(int), compareInts);
+	qsort(heap->removed, heap->removedCount, sizeof(int), compareInts);
+	int i, j = 0, live = 0;
+	for (i = 0; i < heap->count; i++)
 	{
-		int position = 0;
-		GET_HEAD_ITERATOR;;
-		while (iterator != NULL)
-		{
-			if (position == index)
-			{
-				*result = iterator->info;
-				return TRUE;
-			}
-			MOVE_NEXT_W_INDEX(position);
-		}
+		while (j < heap->removedCount && heap->removed[j] < heap->items[i]) j++;
+		if (j < heap->removedCount && heap->removed[j] == heap->items[i]) j++;
+		else heap->items[live++] = heap->items[i];
 	}
-	else
+	heap->count = live;
+	heap->removedCount = 0;
+	if (heap->max)
 	{
-		int position = list->length - 1;
-		GET_TAIL_ITERATOR;
-		while (iterator != NULL)
+		for (i = 0; i < live / 2; i++)
 		{
-			if (position == index)
-			{
-				*result = iterator->info;
-				return TRUE;
-			}
-			MOVE_BACK_W_INDEX(position);
+			int temp = heap->items[i];
+			heap->items[i] = heap->items[live - 1 - i];
+			heap->items[live - 1 - i] = temp;
 		}
 	}
-	return FALSE;
 }
 
-// IndexOf
-int index_of(const T item, list_t list)
+// Adds a value to the heap
+static inline void lazyHeapAdd(struct lazyHeap* heap, int value)
 {
-	RETURN_IF_EMPTY(list, -1);
-	int index = 0;
-	GET_HEAD_ITERATOR;
-	while (iterator != NULL)
-	{
-		if (iterator->info == item) return index;
-		MOVE_NEXT_W_INDEX(index);
-	}
-	return -1;
+	heapPush(heap->max, &heap->items, &heap->count, &heap->capacity, value);
 }
 
-// LastIndexOf
-int last_index_of(const T item, list_t list)
+// Removes a value that is inside the heap
+static void lazyHeapRemove(struct lazyHeap* heap, int value)
 {
-	RETURN_IF_EMPTY(list, -1);
-	int index = list->length - 1;
-	GET_TAIL_ITERATOR;
-	while (iterator != NULL)
+	heapPush(heap->max, &heap->removed, &heap->removedCount, &heap->removedCapacity, value);
+	while (heap->removedCount > 0 && heap->items[0] == heap->removed[0])
 	{
-		if (iterator->info == item) return index;
-		MOVE_BACK_W_INDEX(index);
+		heapPop(heap->max, heap->items, &heap->count);
+		heapPop(heap->max, heap->removed, &heap->removedCount);
 	}
-	return -1;
+	if (heap->removedCount > INITIAL_HEAP_CAPACITY
+		&& heap->removedCount > heap->count / 2) lazyHeapPurge(heap);
 }
 
-// Add
-bool_t add(const T item, list_t list)
+/* ---------------------------------------------------------------------
+*  listAggregate
+*  ---------------------------------------------------------------------
+*  Description:
+*    The count, sum, minimum and maximum of the values returned by a
+*    toNumber function for each item of a list_t. All the aggregates of
+*    a list_t are stored in a linked list. */
+struct listAggregate
 {
-	if (list == NULL) return FALSE;
-	nodePointer newNode = (nodePointer)malloc(sizeof(listNode));
-	newNode->info = item;
-	newNode->next = NULL;
-	if (list->length == 0)
-	{		
-		newNode->previous = NULL;
-		list->head = newNode;
-		list->tail = newNode;
+	int(*expression)(T);
+	int count;
+	long long sum;
+	struct lazyHeap min;
+	struct lazyHeap max;
+	struct listAggregate* next;
+};
+
+// Adds the value of an item to the aggregate
+static void aggregateInsert(list_aggregate_t aggregate, const T item)
+{
+	int value = aggregate->expression(item);
+	aggregate->count++;
+	aggregate->sum += value;
+	lazyHeapAdd(&aggregate->min, value);
+	lazyHeapAdd(&aggregate->max, value);
+}
+
+// Removes the value of an item from the aggregate
+static void aggregateRemove(list_aggregate_t aggregate, const T item)
+{
+	int value = aggregate->expression(item);
+	aggregate->count--;
+	aggregate->sum -= value;
+	lazyHeapRemove(&aggregate->min, value);
+	lazyHeapRemove(&aggregate->max, value);
+}
+
+// Removes all the values from the aggregate
+static void aggregateReset(list_aggregate_t aggregate)
+{
+	aggregate->count = 0;
+	aggregate->sum = 0;
+	aggregate->min.count = aggregate->min.removedCount = 0;
+	aggregate->max.count = aggregate->max.removedCount = 0;
+}
+
+// Deallocates the aggregate
+static void aggregateFree(list_aggregate_t aggregate)
+{
+	free(aggregate->min.items);
+	free(aggregate->min.removed);
+	free(aggregate->max.items);
+	free(aggregate->max.removed);
+	free(aggregate);
+}
+
+#define FOR_EACH_AGGREGATE(list) \
+list_aggregate_t aggregate; \
+for (aggregate = list->aggregates; aggregate != NULL; aggregate = aggregate->next)
+
+/* ============================================================================
+*  Range queries
+*  ========================================================================= */
+
+/* ---------------------------------------------------------------------
+*  rangeTree
+*  ---------------------------------------------------------------------
+*  Description:
+*    A bottom-up segment tree over the values that a toNumber function
+*    returns for the items of a list_t. The leaves are stored from the
+*    position size onwards, each inner node i stores the sum, minimum
+*    and maximum of its children 2i and 2i+1. The tree is rebuilt when
+*    it is not valid anymore and a query is performed, since the only
+*    edit that can be applied in place is the replacement of an item
+*    in a known position (see replace_at). */
+struct rangeTree
+{
+	int(*expression)(T);
+	long long* sums;
+	int* mins;
+	int* maxs;
+	int size;
+	int capacity;
+	bool_t valid;
+};
+
+// Recomputes the inner node i from its children
+static inline void rangeTreePull(struct rangeTree* tree, int i)
+{
+	int left = i << 1, right = left | 1;
+	tree->sums[i] = tree->sums[left] + tree->sums[right];
+	tree->mins[i] = tree->mins[left] < tree->mins[right] ? tree->mins[left] : tree->mins[right];
+	tree->maxs[i] = tree->maxs[left] > tree->maxs[right] ? tree->maxs[left] : tree->maxs[right];
+}
+
+// Builds the tree with the current items of the list_t
+static void rangeTreeBuild(list_t list)
+{
+	struct rangeTree* tree = list->ranges;
+	int n = list->length, i;
+	if (n > tree->capacity)
+	{
+		tree->capacity = n;
+		tree->sums = (long long*)realloc(tree->sums, sizeof(long long) * 2 * n);
+		tree->mins = (int*)realloc(tree->mins, sizeof(int) * 2 * n);
+		tree->maxs = (int*)realloc(tree->maxs, sizeof(int) * 2 * n);
+	}
+	tree->size = n;
+	nodePointer iterator = list->head;
+	for (i = n; i < 2 * n; i++)
+	{
+		int value = tree->expression(iterator->info);
+		tree->sums[i] = value;
+		tree->mins[i] = value;
+		tree->maxs[i] = value;
+		iterator = iterator->next;
+	}
+	for (i = n - 1; i > 0; i--) rangeTreePull(tree, i);
+	tree->valid = TRUE;
+}
+
+// Updates the leaf in the given position and all its ancestors
+static void rangeTreeUpdate(struct rangeTree* tree, int position, const T item)
+{
+	int i = position + tree->size, value = tree->expression(item);
+	tree->sums[i] = value;
+	tree->mins[i] = value;
+	tree->maxs[i] = value;
+	for (i >>= 1; i > 0; i >>= 1) rangeTreePull(tree, i);
+	tree->valid = TRUE;
+}
+
+// Deallocates the tree
+static void rangeTreeFree(struct rangeTree* tree)
+{
+	free(tree->sums);
+	free(tree->mins);
+	free(tree->maxs);
+	free(tree);
+}
+
+#define INVALIDATE_RANGES(list) if (list->ranges != NULL) list->ranges->valid = FALSE
+
+/* ============================================================================
+*  Views
+*  ========================================================================= */
+
+// Single entry inside a bucket of the map of a view
+struct viewEntry
+{
+	nodePointer source;
+	nodePointer target;
+	struct viewEntry* next;
+};
+
+/* ---------------------------------------------------------------------
+*  listView
+*  ---------------------------------------------------------------------
+*  Description:
+*    A list_t that contains the items of a source list_t that satisfy a
+*    predicate, transformed by a deriver, in the same order. The view
+*    has a hash map from each source node to the node that contains its
+*    derived item, so that each edit of the source list_t is applied to
+*    the view in O(1) expected time. All the views of a list_t are
+*    stored in a linked list. */
+struct listView
+{
+	list_t source;
+	list_t output;
+	bool_t(*condition)(T);
+	T(*transform)(T);
+	struct viewEntry** buckets;
+	unsigned int mask;
+	int count;
+	struct viewEntry* recycled;
+	struct listView* next;
+};
+
+// The functions that update the views are defined at the end of the file,
+// since they use the same functions to add and remove nodes as list_t
+static void viewInsert(list_view_t view, nodePointer node);
+static void viewRemove(list_view_t view, nodePointer node);
+static void viewReplace(list_view_t view, nodePointer node);
+static void viewMove(list_view_t view, nodePointer old, nodePointer node);
+static void viewReset(list_view_t view);
+static void viewRebuild(list_view_t view);
+
+#define FOR_EACH_VIEW(list) \
+list_view_t view; \
+for (view = list->views; view != NULL; view = view->next)
+
+/* ============================================================================
+*  Observers
+*  ========================================================================= */
+
+#ifdef LIST_T_OBSERVERS
+
+// Single observer of a list_t, with its context
+struct listObserver
+{
+	list_observer_t observer;
+	void* ctx;
+	struct listObserver* next;
+};
+
+// Returns the index of a node, walking at the same time from both the ends of the
+// list_t and in both directions from the last node an event was sent for. This way
+// the cost is O(1) for the nodes close to an end or to the previous event.
+// A node that has just been added shifts the index of all the following ones,
+// so in that case the previous node can only be used if it comes before it.
+static int observedIndexOf(list_t list, nodePointer node, bool_t added)
+{
+	nodePointer fromHead = list->head, fromTail = list->tail;
+	nodePointer forward = list->observedNode, back = added ? NULL : list->observedNode;
+	int distance = 0;
+	while (TRUE)
+	{
+		if (fromHead == node) return distance;
+		if (fromTail == node) return list->length - 1 - distance;
+		if (forward == node) return list->observedIndex + distance;
+		if (back == node) return list->observedIndex - distance;
+		fromHead = fromHead->next;
+		fromTail = fromTail->previous;
+		if (forward != NULL) forward = forward->next;
+		if (back != NULL) back = back->previous;
+		distance++;
+	}
+}
+
+// Sends an event to all the observers of the list_t
+static void sendEvent(list_t list, list_operation op, int index, const T* old, const T* current)
+{
+	struct listObserver* item;
+	for (item = list->observers; item != NULL; item = item->next)
+	{
+		item->observer(list, op, index, old, current, item->ctx);
+	}
+}
+
+// Sends the event for an added, removed or replaced node
+static void observeNode(list_t list, list_operation op, nodePointer node, const T* old)
+{
+	int index = observedIndexOf(list, node, op == LIST_ADD);
+	sendEvent(list, op, index, old, op == LIST_REMOVE ? NULL : &node->info);
+
+	// A removed node is about to be deallocated, so the previous one is saved
+	if (op != LIST_REMOVE)
+	{
+		list->observedNode = node;
+		list->observedIndex = index;
 	}
 	else
 	{
-		newNode->previous = list->tail;
-		list->tail->next = newNode;
-		list->tail = newNode;
+		list->observedNode = node->previous;
+		list->observedIndex = index - 1;
+	}
+}
+
+// Sends an event that is not related to a single node
+static void observeList(list_t list, list_operation op)
+{
+	list->observedNode = NULL;
+	sendEvent(list, op, -1, NULL, NULL);
+}
+
+#define OBSERVE_NODE(list, op, node, old) if (list->observers != NULL) observeNode(list, op, node, old)
+#define OBSERVE_LIST(list, op) if (list->observers != NULL) observeList(list, op)
+#define HAS_OBSERVERS(list) (list->observers != NULL)
+
+// A moved node keeps its index, so only the cached pointer has to be updated
+#define OBSERVE_MOVE(list, old, node) if (list->observedNode == old) list->observedNode = node
+
+#else
+
+#define OBSERVE_NODE(list, op, node, old)
+#define OBSERVE_LIST(list, op)
+#define HAS_OBSERVERS(list) FALSE
+#define OBSERVE_MOVE(list, old, node)
+
+#endif
+
+/* ============================================================================
+*  Notifications
+*  ========================================================================= */
+
+// Each function that edits the nodes of a list_t calls these functions, which
+// keep the optional structures attached to the list_t up to date.
+
+// A new node has been linked to the list_t
+static inline void notifyInsert(list_t list, nodePointer node)
+{
+	INVALIDATE_RANGES(list);
+	if (list->index != NULL) hashIndexInsert(list->index, node);
+	if (list->filter != NULL) bloomFilterInsert(list, node->info);
+	FOR_EACH_AGGREGATE(list) aggregateInsert(aggregate, node->info);
+	FOR_EACH_VIEW(list) viewInsert(view, node);
+	OBSERVE_NODE(list, LIST_ADD, node, NULL);
+}
+
+// A node is about to be unlinked from the list_t
+static inline void notifyRemove(list_t list, nodePointer node)
+{
+	OBSERVE_NODE(list, LIST_REMOVE, node, &node->info);
+	INVALIDATE_RANGES(list);
+	if (list->index != NULL) hashIndexRemove(list->index, node, node->info);
+	FOR_EACH_AGGREGATE(list) aggregateRemove(aggregate, node->info);
+	FOR_EACH_VIEW(list) viewRemove(view, node);
+}
+
+// The item of a node has been changed, old is its previous value
+static inline void notifyReplace(list_t list, nodePointer node, const T old)
+{
+	INVALIDATE_RANGES(list);
+	if (list->index != NULL)
+	{
+		hashIndexRemove(list->index, node, old);
+		hashIndexInsert(list->index, node);
+	}
+	if (list->filter != NULL) bloomFilterInsert(list, node->info);
+	FOR_EACH_AGGREGATE(list)
+	{
+		aggregateRemove(aggregate, old);
+		aggregateInsert(aggregate, node->info);
+	}
+	FOR_EACH_VIEW(list) viewReplace(view, node);
+	OBSERVE_NODE(list, LIST_REPLACE, node, &old);
+}
+
+// A node has been copied to a new address, with the same item and position.
+// The Bloom filter, the aggregates and the range queries tree only depend on
+// the items and their order, so just the structures that store nodes change
+static inline void notifyMove(list_t list, nodePointer old, nodePointer node)
+{
+	if (list->index != NULL) hashIndexMove(list->index, old, node);
+	FOR_EACH_VIEW(list) viewMove(view, old, node);
+	OBSERVE_MOVE(list, old, node);
+}
+
+// All the nodes have been removed from the list_t
+static inline void notifyClear(list_t list)
+{
+	INVALIDATE_RANGES(list);
+	if (list->index != NULL) hashIndexReset(list->index);
+	if (list->filter != NULL) bloomFilterReset(list->filter);
+	FOR_EACH_AGGREGATE(list) aggregateReset(aggregate);
+	FOR_EACH_VIEW(list) viewReset(view);
+	OBSERVE_LIST(list, LIST_CLEAR);
+}
+
+// The order of the nodes has changed, but their items have not
+static inline void notifyReorder(list_t list)
+{
+	INVALIDATE_RANGES(list);
+	FOR_EACH_VIEW(list) viewRebuild(view);
+	OBSERVE_LIST(list, LIST_REORDER);
+}
+
+#define HAS_ATTACHMENTS(list)                                   \
+(list->index != NULL || list->filter != NULL                    \
+	|| list->aggregates != NULL || list->views != NULL          \
+	|| HAS_OBSERVERS(list))
+
+// Sends the insert notification for count nodes, starting from the given one
+static void notifyInsertRange(list_t list, nodePointer node, int count)
+{
+	INVALIDATE_RANGES(list);
+	if (!HAS_ATTACHMENTS(list)) return;
+	while (count-- > 0)
+	{
+		notifyInsert(list, node);
+		node = node->next;
+	}
+}
+
+// Sends the remove notification for count nodes, going back from the given one:
+// this way each index is still valid after the previous nodes have been removed
+static void notifyRemoveRange(list_t list, nodePointer node, int count)
+{
+	INVALIDATE_RANGES(list);
+	if (!HAS_ATTACHMENTS(list)) return;
+	while (count-- > 0)
+	{
+		notifyRemove(list, node);
+		node = node->previous;
 	}
+}
+
+/* ============================================================================
+*  Generic functions
+*  ========================================================================= */
+
+// Create
+list_t create()
+{
+	list_t outList = (list_t)malloc(sizeof(struct listBase));
+	outList->head = NULL;
+	outList->tail = NULL;
+	outList->length = 0;
+	outList->sync = 0;
+	outList->compactCursor = NULL;
+	outList->compactPosition = 0;
+	outList->compactSync = 0;
+	outList->index = NULL;
+	outList->filter = NULL;
+	outList->aggregates = NULL;
+	outList->ranges = NULL;
+	outList->views = NULL;
+#ifdef LIST_T_OBSERVERS
+	outList->observers = NULL;
+	outList->observedNode = NULL;
+#endif
+	return outList;
+}
+
+#define GET_ITERATOR(target) nodePointer iterator = target
+#define GET_HEAD_ITERATOR GET_ITERATOR(list->head)
+#define GET_TAIL_ITERATOR GET_ITERATOR(list->tail)
+#define MOVE_NEXT iterator = iterator->next
+#define MOVE_NEXT_W_INDEX(index) MOVE_NEXT; index++
+#define MOVE_BACK iterator = iterator->previous
+#define MOVE_BACK_W_INDEX(index) MOVE_BACK; index--
+#define SYNC_PLUS list->sync++;
+
+// Allocates count > 0 nodes with a single malloc call and links them to each other
+// in address order. The first previous and the last next pointers are not set.
+static nodePointer allocateBlock(int count)
+{
+	struct nodeBlock* block = (struct nodeBlock*)malloc(sizeof(struct nodeBlock) + sizeof(listNode) * count);
+	block->live = count;
+	nodePointer nodes = block->nodes;
+	int i;
+	for (i = 0; i < count; i++)
+	{
+		nodes[i].block = block;
+		nodes[i].previous = nodes + i - 1;
+		nodes[i].next = nodes + i + 1;
+	}
+	return nodes;
+}
+
+// Allocates count > 0 nodes with a single malloc call and links them in address
+// order at the end of the list_t. Returns the first one: the caller has to assign
+// the items, which are stored contiguously from the returned node onwards.
+static nodePointer appendNodes(list_t list, int count)
+{
+	nodePointer nodes = allocateBlock(count);
+	nodes[0].previous = list->tail;
+	nodes[count - 1].next = NULL;
+	if (list->tail == NULL) list->head = nodes;
+	else list->tail->next = nodes;
+	list->tail = nodes + count - 1;
+	list->length += count;
+	SYNC_PLUS;
+	return nodes;
+}
+
+// Allocates a node with the given item and links it before the target node,
+// or at the end of the list_t if the target is NULL. Updates the length.
+static nodePointer linkBefore(list_t list, nodePointer target, const T item)
+{
+	nodePointer newNode = allocateNode();
+	newNode->info = item;
+	newNode->next = target;
+	newNode->previous = target == NULL ? list->tail : target->previous;
+	if (newNode->previous == NULL) list->head = newNode;
+	else newNode->previous->next = newNode;
+	if (target == NULL) list->tail = newNode;
+	else target->previous = newNode;
 	list->length++;
+	notifyInsert(list, newNode);
+	return newNode;
+}
+
+// Unlinks the given node from its list_t and deallocates it. Updates the length.
+static void unlinkNode(list_t list, nodePointer node)
+{
+	notifyRemove(list, node);
+	if (node == list->compactCursor) list->compactCursor = node->next;
+	if (node->previous == NULL) list->head = node->next;
+	else node->previous->next = node->next;
+	if (node->next == NULL) list->tail = node->previous;
+	else node->next->previous = node->previous;
+	freeNode(node);
+	list->length--;
+}
+
+// Returns the node at the given valid index, starting from the closest end
+static nodePointer nodeAt(list_t list, int index)
+{
+	nodePointer iterator;
+	if (index <= list->length / 2)
+	{
+		iterator = list->head;
+		while (index-- > 0) MOVE_NEXT;
+	}
+	else
+	{
+		iterator = list->tail;
+		index = list->length - 1 - index;
+		while (index-- > 0) MOVE_BACK;
+	}
+	return iterator;
+}
+
+#define CLEAR_LIST_OF(list)   \
+list->length = 0;             \
+list->head = NULL;            \
+list->tail = NULL;            \
+list->compactCursor = NULL;   \
+list->compactPosition = 0
+
+#define CLEAR_LIST CLEAR_LIST_OF(list)
+
+// Clear
+bool_t clear(list_t list)
+{
+	if (list == NULL) return FALSE;
+	if (list->length == 0) return TRUE;
 	SYNC_PLUS;
+	notifyClear(list);
+	if (list->length == 1)
+	{
+		freeNode(list->head);
+		CLEAR_LIST;
+		return TRUE;
+	}
+	GET_ITERATOR(list->head->next);
+	while (TRUE)
+	{
+		freeNode(iterator->previous);
+		if (iterator->next == NULL)
+		{
+			freeNode(iterator);
+			break;
+		}
+		MOVE_NEXT;
+	}
+	CLEAR_LIST;
 	return TRUE;
 }
 
-// AddAt
-bool_t add_at(const T item, list_t list, int index)
+// Destroy
+bool_t destroy(list_t* list)
+{
+	if (clear(*list))
+	{
+		if ((*list)->index != NULL) hashIndexFree((*list)->index);
+		if ((*list)->filter != NULL) bloomFilterFree((*list)->filter);
+		while ((*list)->aggregates != NULL)
+		{
+			list_aggregate_t next = (*list)->aggregates->next;
+			aggregateFree((*list)->aggregates);
+			(*list)->aggregates = next;
+		}
+		if ((*list)->ranges != NULL) rangeTreeFree((*list)->ranges);
+
+		// The views stay valid, but they are no longer bound to the list_t
+		while ((*list)->views != NULL)
+		{
+			list_view_t next = (*list)->views->next;
+			(*list)->views->source = NULL;
+			(*list)->views = next;
+		}
+#ifdef LIST_T_OBSERVERS
+		while ((*list)->observers != NULL)
+		{
+			struct listObserver* next = (*list)->observers->next;
+			free((*list)->observers);
+			(*list)->observers = next;
+		}
+#endif
+		free(*list);
+		*list = NULL;
+		return TRUE;
+	}
+	return FALSE;
+}
+
+#define ASSIGN_IF_NOT_NULL(value)    \
+if (result != NULL) *result = value
+
+// DestroySequence
+void destroy_sequence(bool_t* result, list_t** pending)
+{
+	if (pending == NULL)
+	{
+		ASSIGN_IF_NOT_NULL(FALSE);
+		return;
+	}
+	if (*pending == NULL)
+	{
+		ASSIGN_IF_NOT_NULL(FALSE);
+		return;
+	}
+	bool_t destroyed = FALSE;
+	while (*pending)
+	{
+		destroy(*pending);
+		destroyed = TRUE;
+		pending++;
+	}
+	ASSIGN_IF_NOT_NULL(destroyed);
+}
+
+// Copy
+list_t copy(const list_t source)
+{
+	if (source == NULL) return NULL;
+	list_t outList = create();
+	if (source->length == 0) return outList;
+	nodePointer nodes = appendNodes(outList, source->length);
+	int i = 0;
+	GET_ITERATOR(source->head);
+	while (iterator != NULL)
+	{
+		nodes[i++].info = iterator->info;
+		MOVE_NEXT;
+	}
+	return outList;
+}
+
+// Create random
+list_t create_random(int length, int min, int max)
+{
+	if (min >= max) return NULL;
+	if (length == 0) return create();
+	list_t outList = create();
+	srand((unsigned)time(NULL));
+	nodePointer nodes = appendNodes(outList, length);
+	int i;
+	for (i = 0; i < length; i++)
+	{
+		nodes[i].info = (T)((rand() % (max - min)) + min);
+	}
+	return outList;
+}
+
+// CreateFrom
+list_t create_from(T* array, int size)
+{
+	if (array == NULL || size <= 0) return NULL;
+	list_t outList = create();
+	add_range(outList, array, size);
+	return outList;
+}
+
+// AddRange
+bool_t add_range(list_t list, const T* array, int size)
+{
+	if (list == NULL || array == NULL || size <= 0) return FALSE;
+	nodePointer nodes = appendNodes(list, size);
+	int i;
+	for (i = 0; i < size; i++) nodes[i].info = array[i];
+	notifyInsertRange(list, nodes, size);
+	return TRUE;
+}
+
+// ToArray
+T* to_array(list_t list, int* size)
+{
+	if (list == NULL || list->length == 0)
+	{
+		*size = -1;
+		return NULL;
+	}
+	*size = list->length;
+	T* array = (T*)malloc(sizeof(T) * (*size));
+	int i = 0;
+	GET_HEAD_ITERATOR;
+	while (iterator != NULL)
+	{
+		array[i] = iterator->info;
+		i++;
+		MOVE_NEXT;
+	}
+	return array;
+}
+
+#define CHECK_EMPTY(list) list == NULL || list->length == 0
+#define NULL_IF_EMPTY(list) if (CHECK_EMPTY(list)) return NULL
+#define RETURN_IF_EMPTY(list, value) if (CHECK_EMPTY(list)) return value
+
+// IsEmpty
+bool_t is_empty(list_t list)
+{
+	return CHECK_EMPTY(list);
+}
+
+// Returns TRUE if the Bloom filter or the hash index of the list_t show that
+// the item is not inside the list_t, without walking the nodes
+static inline bool_t surelyAbsent(list_t list, const T item)
+{
+	if (list->filter != NULL && !bloomFilterMayContain(list->filter, item)) return TRUE;
+	return list->index != NULL && hashIndexFind(list->index, item, NULL) == NULL;
+}
+
+// IsElement
+bool_t is_element(const T item, list_t list)
+{
+	RETURN_IF_EMPTY(list, FALSE);
+	if (surelyAbsent(list, item)) return FALSE;
+	if (list->index != NULL) return TRUE;
+	GET_HEAD_ITERATOR;
+	while (iterator != NULL)
+	{
+		if (iterator->info == item) return TRUE;
+		MOVE_NEXT;
+	}
+	return FALSE;
+}
+
+// Inline function used inside the get_first and peek functions
+static inline bool_t GetFirst(list_t list, T* result)
+{
+	RETURN_IF_EMPTY(list, FALSE);
+	*result = list->head->info;
+	return TRUE;
+}
+
+// GetFirst
+bool_t get_first(list_t list, T* result)
+{
+	return GetFirst(list, result);
+}
+
+// GetLast
+bool_t get_last(list_t list, T* result)
+{
+	RETURN_IF_EMPTY(list, FALSE);
+	*result = list->tail->info;
+	return TRUE;
+}
+
+// Get
+bool_t get(list_t list, int index, T* result)
+{
+	if (index < 0 || index >= list->length) return FALSE;
+	bool_t fromHead = index <= list->length / 2;
+	if (fromHead)
+	{
+		int position = 0;
+		GET_HEAD_ITERATOR;;
+		while (iterator != NULL)
+		{
+			if (position == index)
+			{
+				*result = iterator->info;
+				return TRUE;
+			}
+			MOVE_NEXT_W_INDEX(position);
+		}
+	}
+	else
+	{
+		int position = list->length - 1;
+		GET_TAIL_ITERATOR;
+		while (iterator != NULL)
+		{
+			if (position == index)
+			{
+				*result = iterator->info;
+				return TRUE;
+			}
+			MOVE_BACK_W_INDEX(position);
+		}
+	}
+	return FALSE;
+}
+
+#define MINUS_ONE_IF_ABSENT(item) if (surelyAbsent(list, item)) return -1
+
+// IndexOf
+int index_of(const T item, list_t list)
+{
+	RETURN_IF_EMPTY(list, -1);
+	MINUS_ONE_IF_ABSENT(item);
+	int index = 0;
+	GET_HEAD_ITERATOR;
+	while (iterator != NULL)
+	{
+		if (iterator->info == item) return index;
+		MOVE_NEXT_W_INDEX(index);
+	}
+	return -1;
+}
+
+// LastIndexOf
+int last_index_of(const T item, list_t list)
+{
+	RETURN_IF_EMPTY(list, -1);
+	MINUS_ONE_IF_ABSENT(item);
+	int index = list->length - 1;
+	GET_TAIL_ITERATOR;
+	while (iterator != NULL)
+	{
+		if (iterator->info == item) return index;
+		MOVE_BACK_W_INDEX(index);
+	}
+	return -1;
+}
+
+// Add
+bool_t add(const T item, list_t list)
+{
+	if (list == NULL) return FALSE;
+	linkBefore(list, NULL, item);
+	SYNC_PLUS;
+	return TRUE;
+}
+
+// AddAt
+bool_t add_at(const T item, list_t list, int index)
+{
+	if (CHECK_EMPTY(list) || index < 0 || index >= list->length) return FALSE;
+	linkBefore(list, nodeAt(list, index), item);
+	SYNC_PLUS;
+	return TRUE;
+}
+
+// AddAll
+bool_t add_all(list_t target, const list_t source)
+{
+	if (target == NULL) return FALSE;
+	RETURN_IF_EMPTY(source, FALSE);
+
+	// The length is read first, so the target can also be the source list_t
+	int length = source->length, i;
+	GET_ITERATOR(source->head);
+	nodePointer nodes = appendNodes(target, length);
+	for (i = 0; i < length; i++)
+	{
+		nodes[i].info = iterator->info;
+		MOVE_NEXT;
+	}
+	notifyInsertRange(target, nodes, length);
+	return TRUE;
+}
+
+// ListSpliceBack
+bool_t list_splice_back(list_t target, list_t source)
+{
+	if (target == NULL || source == NULL || target == source) return FALSE;
+	if (source->length == 0) return TRUE;
+	nodePointer first = source->head;
+	int moved = source->length;
+	if (target->length == 0) target->head = source->head;
+	else
+	{
+		target->tail->next = source->head;
+		source->head->previous = target->tail;
+	}
+	target->tail = source->tail;
+	target->length += source->length;
+	target->sync++;
+	source->sync++;
+	notifyClear(source);
+	CLEAR_LIST_OF(source);
+	notifyInsertRange(target, first, moved);
+	return TRUE;
+}
+
+// ListSpliceRange
+bool_t list_splice_range(list_t target, int index, list_t source, int start, int end)
+{
+	if (target == NULL || source == NULL || target == source) return FALSE;
+	if (index < 0 || index > target->length || start < 0 || end < start
+		|| end >= source->length) return FALSE;
+
+	// Detach the range from the source list_t
+	nodePointer first = nodeAt(source, start), last = first;
+	int moved = end - start + 1, i;
+	bool_t cursorMoved = first == source->compactCursor;
+	for (i = 1; i < moved; i++)
+	{
+		last = last->next;
+		if (last == source->compactCursor) cursorMoved = TRUE;
+	}
+
+	// A compaction of the source list_t continues after the moved nodes
+	if (cursorMoved) source->compactCursor = last->next;
+	notifyRemoveRange(source, last, moved);
+	if (first->previous == NULL) source->head = last->next;
+	else first->previous->next = last->next;
+	if (last->next == NULL) source->tail = first->previous;
+	else last->next->previous = first->previous;
+	source->length -= moved;
+	source->sync++;
+
+	// Link it before the node in the target position
+	nodePointer position = index == target->length ? NULL : nodeAt(target, index);
+	first->previous = position == NULL ? target->tail : position->previous;
+	last->next = position;
+	if (first->previous == NULL) target->head = first;
+	else first->previous->next = first;
+	if (position == NULL) target->tail = last;
+	else position->previous = last;
+	target->length += moved;
+	target->sync++;
+	notifyInsertRange(target, first, moved);
+	return TRUE;
+}
+
+// ListCompactStep
+int list_compact_step(list_t list, int count)
+{
+	if (list == NULL || count <= 0) return -1;
+	if (list->length == 0) return 0;
+
+	// A new compaction starts from the first node, unless the previous one has
+	// reached the end and the list_t hasn't been edited since then
+	if (list->compactPosition == -1 && list->compactSync == list->sync) return 0;
+	if (list->compactPosition == -1 || (list->compactPosition == 0 && list->compactCursor == NULL))
+	{
+		list->compactCursor = list->head;
+		list->compactPosition = 0;
+	}
+
+	// Count the nodes to move: the cursor is kept across the edits of the list_t,
+	// so the number of nodes after it is not known in advance
+	int moved = 0, i;
+	GET_ITERATOR(list->compactCursor);
+	while (moved < count && iterator != NULL)
+	{
+		MOVE_NEXT;
+		moved++;
+	}
+
+	// Move the next items inside a single block, in traversal order.
+	// The items don't change, so the observers don't receive any event
+	if (moved > 0)
+	{
+		nodePointer nodes = allocateBlock(moved), before = list->compactCursor->previous;
+		iterator = list->compactCursor;
+		for (i = 0; i < moved; i++)
+		{
+			nodes[i].info = iterator->info;
+			nodePointer temp = iterator;
+			MOVE_NEXT;
+			notifyMove(list, temp, nodes + i);
+			freeNode(temp);
+		}
+		nodes[0].previous = before;
+		nodes[moved - 1].next = iterator;
+		if (before == NULL) list->head = nodes;
+		else before->next = nodes;
+		if (iterator == NULL) list->tail = nodes + moved - 1;
+		else iterator->previous = nodes + moved - 1;
+		SYNC_PLUS;
+	}
+
+	// Save the state for the following step
+	list->compactCursor = iterator;
+	if (iterator == NULL)
+	{
+		list->compactPosition = -1;
+		list->compactSync = list->sync;
+		return 0;
+	}
+	list->compactPosition += moved;
+	return list->length > list->compactPosition ? list->length - list->compactPosition : 1;
+}
+
+// ListCompact
+bool_t list_compact(list_t list)
+{
+	RETURN_IF_EMPTY(list, FALSE);
+	list->compactCursor = NULL;
+	list->compactPosition = 0;
+	list_compact_step(list, list->length);
+	return TRUE;
+}
+
+// Maximum distance between two consecutive nodes to consider them close in memory
+#define LOCALITY_WINDOW 4096
+
+// ListLocality
+float list_locality(list_t list)
+{
+	RETURN_IF_EMPTY(list, -1);
+	if (list->length == 1) return 1;
+	int close = 0;
+	GET_HEAD_ITERATOR;
+	while (iterator->next != NULL)
+	{
+		ptrdiff_t distance = (char*)iterator->next - (char*)iterator;
+		if (distance > 0 && distance <= LOCALITY_WINDOW) close++;
+		MOVE_NEXT;
+	}
+	return (float)close / (list->length - 1);
+}
+
+#define SIZE(list) list == NULL ? -1 : list->length
+
+// Size
+int size(list_t list)
+{
+	return SIZE(list);
+}
+
+// Returns the node with the given item if it is the only one inside an indexed
+// list_t. Returns NULL if the list_t has no index or the item is not unique.
+static inline nodePointer uniqueIndexedNode(list_t list, const T item)
+{
+	if (list->index == NULL) return NULL;
+	int matches;
+	nodePointer node = hashIndexFind(list->index, item, &matches);
+	return matches == 1 ? node : NULL;
+}
+
+// Returns the first node with the given item, or NULL
+static nodePointer findNode(list_t list, const T item)
+{
+	if (surelyAbsent(list, item)) return NULL;
+	if (list->index != NULL)
+	{
+		nodePointer node = uniqueIndexedNode(list, item);
+		if (node != NULL) return node;
+	}
+	GET_HEAD_ITERATOR;
+	while (iterator != NULL)
+	{
+		if (iterator->info == item) return iterator;
+		MOVE_NEXT;
+	}
+	return NULL;
+}
+
+// RemoveItem
+bool_t remove_item(const T item, list_t list)
+{
+	RETURN_IF_EMPTY(list, FALSE);
+	nodePointer node = findNode(list, item);
+	if (node == NULL) return FALSE;
+	unlinkNode(list, node);
+	SYNC_PLUS;
+	return TRUE;
+}
+
+// RemoveAt
+bool_t remove_at(list_t list, int index)
+{
+	RETURN_IF_EMPTY(list, FALSE);
+	if (index < 0 || index >= list->length) return FALSE;
+	unlinkNode(list, nodeAt(list, index));
+	SYNC_PLUS;
+	return TRUE;
+}
+
+// RemoveAllItems
+int remove_all_items(const T item, list_t list)
+{
+	RETURN_IF_EMPTY(list, -1);
+	int total = 0;
+	if (list->index != NULL)
+	{
+		nodePointer node;
+		while ((node = hashIndexFind(list->index, item, NULL)) != NULL)
+		{
+			unlinkNode(list, node);
+			total++;
+		}
+	}
+	else
+	{
+		GET_HEAD_ITERATOR;
+		while (iterator != NULL)
+		{
+			nodePointer temp = iterator;
+			MOVE_NEXT;
+			if (temp->info == item)
+			{
+				unlinkNode(list, temp);
+				total++;
+			}
+		}
+	}
+	if (total == 0) return -1;
+	SYNC_PLUS;
+	return total;
+}
+
+// Assigns a new item to the given node
+static inline void replaceNode(list_t list, nodePointer node, const T item)
+{
+	T old = node->info;
+	node->info = item;
+	notifyReplace(list, node, old);
+}
+
+// ReplaceItem
+bool_t replace_item(const T target, const T replacement, list_t list)
+{
+	RETURN_IF_EMPTY(list, FALSE);
+	nodePointer node = findNode(list, target);
+	if (node == NULL) return FALSE;
+	replaceNode(list, node, replacement);
+	SYNC_PLUS;
+	return TRUE;
+}
+
+// ReplaceAt
+bool_t replace_at(const T item, list_t list, int index)
+{
+	if (list == NULL || index < 0 || index >= list->length) return FALSE;
+
+	// A valid range tree can be updated in place, since the position is known
+	bool_t update = list->ranges != NULL && list->ranges->valid;
+	replaceNode(list, nodeAt(list, index), item);
+	if (update) rangeTreeUpdate(list->ranges, index, item);
+	SYNC_PLUS;
+	return TRUE;
+}
+
+// ReplaceAllItems
+int replace_all_items(const T target, const T replacement, list_t list)
+{
+	RETURN_IF_EMPTY(list, -1);
+	int total = 0;
+	if (list->index != NULL && target != replacement)
+	{
+		nodePointer node;
+		while ((node = hashIndexFind(list->index, target, NULL)) != NULL)
+		{
+			replaceNode(list, node, replacement);
+			total++;
+		}
+	}
+	else
+	{
+		GET_HEAD_ITERATOR;
+		while (iterator != NULL)
+		{
+			if (iterator->info == target)
+			{
+				replaceNode(list, iterator, replacement);
+				total++;
+			}
+			MOVE_NEXT;
+		}
+	}
+	if (total != 0) SYNC_PLUS;
+	return total == 0 ? -1 : total;
+}
+
+// Swaps the items of two nodes
+static inline void swapNodes(list_t list, nodePointer first, nodePointer second)
+{
+	T temp = first->info;
+	replaceNode(list, first, second->info);
+	replaceNode(list, second, temp);
+}
+
+// Swap
+bool_t swap(list_t list, int index1, int index2)
+{
+	RETURN_IF_EMPTY(list, FALSE);
+	if (index1 < 0 || index1 >= list->length || index2 < 0
+		|| index2 >= list->length || index1==index2) return FALSE;
+	int low = index1 < index2 ? index1 : index2;
+	int high = index1 < index2 ? index2 : index1;
+	nodePointer first, second;
+
+	// Locate both the nodes with a single walk, starting from the closest end
+	if (high < list->length - low)
+	{
+		first = nodeAt(list, low);
+		second = first;
+		while (low++ < high) second = second->next;
+	}
+	else
+	{
+		second = nodeAt(list, high);
+		first = second;
+		while (high-- > low) first = first->previous;
+	}
+	swapNodes(list, first, second);
+	SYNC_PLUS;
+	return TRUE;
+}
+
+// Size of the block of text written to a stream with a single call
+#define TEXT_BLOCK 65536
+
+// Size of the block on the stack used for short lists, and the expected length of an item with its separator
+#define TEXT_LOCAL_BLOCK 1024
+#define TEXT_ITEM_ESTIMATE 16
+
+// TRUE if T is int, so that the items can be written without going through printf
+#define T_IS_INT _Generic((T){ 0 }, int: TRUE, default: FALSE)
+
+// Text being written to a stream in large blocks, or to a string with a maximum length
+typedef struct
+{
+	FILE* stream;
+	char* data;
+	size_t capacity;
+	size_t used;
+	size_t total;
+	bool_t failed;
+} textSink;
+
+// Writes the buffered text of a stream sink
+static void sinkFlush(textSink* sink)
+{
+	if (sink->used > 0 && fwrite(sink->data, 1, sink->used, sink->stream) != sink->used) sink->failed = TRUE;
+	sink->used = 0;
+}
+
+// Appends some text to the sink: strings are truncated, streams are flushed when their block is full
+static void sinkAppend(textSink* sink, const char* text, size_t len)
+{
+	sink->total += len;
+	if (sink->used + len > sink->capacity)
+	{
+		if (sink->stream == NULL) len = sink->capacity - sink->used;
+		else
+		{
+			sinkFlush(sink);
+			if (len > sink->capacity)
+			{
+				if (fwrite(text, 1, len, sink->stream) != len) sink->failed = TRUE;
+				return;
+			}
+		}
+	}
+	if (len == 0) return;
+	memcpy(sink->data + sink->used, text, len);
+	sink->used += len;
+}
+
+// Appends an int in base 10, converting it directly instead of using printf
+static inline void sinkAppendInt(textSink* sink, int value)
+{
+	char digits[12];
+	char* end = digits + sizeof(digits);
+	char* cursor = end;
+	unsigned int magnitude = value < 0 ? 0u - (unsigned int)value : (unsigned int)value;
+	do
+	{
+		*--cursor = (char)('0' + magnitude % 10);
+		magnitude /= 10;
+	} while (magnitude != 0);
+	if (value < 0) *--cursor = '-';
+	sinkAppend(sink, cursor, end - cursor);
+}
+
+// Appends an item formatted with the given pattern
+static void sinkAppendItem(textSink* sink, const char* pattern, T item)
+{
+	char text[64];
+	int len = snprintf(text, sizeof(text), pattern, item);
+	if (len < 0) sink->failed = TRUE;
+	else if ((size_t)len < sizeof(text)) sinkAppend(sink, text, len);
+	else
+	{
+		// Rare case, format the item again inside a buffer that is large enough
+		char* large = (char*)malloc(len + 1);
+		snprintf(large, len + 1, pattern, item);
+		sinkAppend(sink, large, len);
+		free(large);
+	}
+}
+
+// Appends all the items of a list_t, with the separator between each pair of items
+static void sinkAppendList(textSink* sink, list_t list, char* pattern, char* separator)
+{
+	size_t separatorLength = separator == NULL ? 0 : strlen(separator);
+	bool_t fast = T_IS_INT && strcmp(pattern, "%d") == 0;
+	GET_HEAD_ITERATOR;
+	while (iterator != NULL && !sink->failed)
+	{
+		if (fast) sinkAppendInt(sink, *(const int*)&iterator->info);
+		else sinkAppendItem(sink, pattern, iterator->info);
+		if (iterator->next != NULL && separatorLength > 0) sinkAppend(sink, separator, separatorLength);
+		MOVE_NEXT;
+	}
+}
+
+// ListWrite
+bool_t list_write(FILE* stream, list_t list, char* pattern, char* separator)
+{
+	if (stream == NULL || list == NULL || pattern == NULL) return FALSE;
+
+	// Size the block on the length of the list_t, so that short lists don't need a heap allocation
+	char local[TEXT_LOCAL_BLOCK];
+	size_t estimate = (size_t)list->length * TEXT_ITEM_ESTIMATE;
+	size_t capacity = estimate <= TEXT_LOCAL_BLOCK ? TEXT_LOCAL_BLOCK : estimate < TEXT_BLOCK ? estimate : TEXT_BLOCK;
+	textSink sink = { stream, capacity == TEXT_LOCAL_BLOCK ? local : (char*)malloc(capacity), capacity, 0, 0, FALSE };
+	sinkAppendList(&sink, list, pattern, separator);
+	sinkFlush(&sink);
+	if (sink.data != local) free(sink.data);
+	return !sink.failed;
+}
+
+// ListSprint
+int list_sprint(char* buffer, int capacity, list_t list, char* pattern, char* separator)
+{
+	if (list == NULL || pattern == NULL || capacity < 0 || (buffer == NULL && capacity > 0)) return -1;
+	textSink sink = { NULL, buffer, capacity > 0 ? capacity - 1 : 0, 0, 0, FALSE };
+	sinkAppendList(&sink, list, pattern, separator);
+	if (capacity > 0) buffer[sink.used] = '\0';
+	return sink.failed || sink.total > INT_MAX ? -1 : (int)sink.total;
+}
+
+// Number of parsed items added to the list_t with a single allocation
+#define PARSE_BLOCK 65536
+
+// Size of the chunks read from a stream by list_read
+#define READ_CHUNK (1 << 20)
+
+#define IS_SPACE(c) ((c) == ' ' || (c) == '\t' || (c) == '\r' || (c) == '\n')
+
+// Items being parsed: they are collected inside a block and added to the list_t in bulk
+typedef struct
+{
+	list_t list;
+	char separator;
+	bool_t(*parser)(const char*, int, T*);
+	T* items;
+	int count;
+} parseState;
+
+// Adds the parsed items to the list_t
+static inline void parseFlush(parseState* state)
+{
+	if (state->count > 0) add_range(state->list, state->items, state->count);
+	state->count = 0;
+}
+
+// Parses a text that only contains whole items, returns FALSE if one of them is not valid
+static bool_t parseText(parseState* state, const char* text, size_t len)
+{
+	const char* end = text + len;
+	while (text < end)
+	{
+		// Find the next item and remove the spaces around it, empty items are skipped
+		const char* next = (const char*)memchr(text, state->separator, end - text);
+		if (next == NULL) next = end;
+		const char* first = text;
+		const char* last = next;
+		while (first < last && IS_SPACE(*first)) first++;
+		while (last > first && IS_SPACE(last[-1])) last--;
+		if (first < last)
+		{
+			if (last - first > INT_MAX
+				|| !state->parser(first, (int)(last - first), state->items + state->count)) return FALSE;
+			if (++state->count == PARSE_BLOCK) parseFlush(state);
+		}
+		if (next == end) break;
+		text = next + 1;
+	}
+	return TRUE;
+}
+
+// Same as parseText, but it parses base 10 ints with an optional sign in a single pass, without scanf
+static bool_t parseIntText(parseState* state, const char* text, size_t len)
+{
+	const char* end = text + len;
+	char separator = state->separator;
+	while (text < end)
+	{
+		while (text < end && *text != separator && IS_SPACE(*text)) text++;
+		if (text == end) break;
+		if (*text == separator)
+		{
+			text++;
+			continue;
+		}
+
+		// Read at most 10 significant digits in a 64 bit value, so that the overflow is checked just once
+		bool_t negative = *text == '-';
+		if (negative || *text == '+') text++;
+		const char* start = text;
+		while (text < end && *text == '0') text++;
+		const char* digits = text;
+		unsigned long long value = 0;
+		while (text < end && (unsigned int)(*text - '0') <= 9)
+		{
+			value = value * 10 + (unsigned int)(*text - '0');
+			if (++text - digits > 10) return FALSE;
+		}
+		if (text == start || value > (negative ? (unsigned long long)INT_MAX + 1 : INT_MAX)) return FALSE;
+		*(int*)(state->items + state->count) = negative ? -(int)(value - 1) - 1 : (int)value;
+		if (++state->count == PARSE_BLOCK) parseFlush(state);
+
+		// Only spaces are allowed between the item and the next separator
+		while (text < end && *text != separator && IS_SPACE(*text)) text++;
+		if (text < end && *text++ != separator) return FALSE;
+	}
+	return TRUE;
+}
+
+// Parses the given text with the custom parser, or as a sequence of ints if there isn't one
+static inline bool_t parseChunk(parseState* state, const char* text, size_t len)
+{
+	return state->parser == NULL ? parseIntText(state, text, len) : parseText(state, text, len);
+}
+
+// Initializes the state of a parser, returns FALSE if T is not int and there is no custom parser
+static bool_t parseStart(parseState* state, char separator, bool_t(*parser)(const char*, int, T*))
+{
+	if (parser == NULL && !T_IS_INT) return FALSE;
+	state->list = create();
+	state->separator = separator;
+	state->parser = parser;
+	state->items = (T*)malloc(PARSE_BLOCK * sizeof(T));
+	state->count = 0;
+	return TRUE;
+}
+
+// Adds the last items and returns the list_t, or destroys it and returns NULL if the text was not valid
+static list_t parseEnd(parseState* state, bool_t valid)
+{
+	if (valid) parseFlush(state);
+	else destroy(&state->list);
+	free(state->items);
+	return state->list;
+}
+
+// ListParse
+list_t list_parse(const char* buffer, size_t len, char separator, bool_t(*parser)(const char*, int, T*))
+{
+	parseState state;
+	if (buffer == NULL || !parseStart(&state, separator, parser)) return NULL;
+	return parseEnd(&state, parseChunk(&state, buffer, len));
+}
+
+// ListRead
+list_t list_read(FILE* stream, char separator, bool_t(*parser)(const char*, int, T*))
+{
+	parseState state;
+	if (stream == NULL || !parseStart(&state, separator, parser)) return NULL;
+	size_t capacity = READ_CHUNK, used = 0, count;
+	char* text = (char*)malloc(capacity);
+	bool_t valid = TRUE;
+	while (valid)
+	{
+		// Grow the buffer only if a single item is longer than it
+		if (used == capacity)
+		{
+			capacity <<= 1;
+			text = (char*)realloc(text, capacity);
+		}
+		count = fread(text + used, 1, capacity - used, stream);
+		if (count == 0) break;
+		used += count;
+
+		// Parse up to the last separator and keep the partial item for the next chunk
+		size_t end = used;
+		while (end > 0 && text[end - 1] != separator) end--;
+		if (end == 0) continue;
+		valid = parseChunk(&state, text, end);
+		memmove(text, text + end, used - end);
+		used -= end;
+	}
+	if (ferror(stream)) valid = FALSE;
+	if (valid) valid = parseChunk(&state, text, used);
+	free(text);
+	return parseEnd(&state, valid);
+}
+
+// FormattedPrint
+bool_t formatted_print(char* pattern, list_t list)
+{
+	if (list == NULL)
+	{
+		printf("NULL list");
+		return FALSE;
+	}
+	if (list->length == 0)
+	{
+		printf("Empty list");
+		return FALSE;
+	}
+	return list_write(stdout, list, pattern, ", ");
+}
+
+// Print
+bool_t print(char* pattern, list_t list)
+{
+	if (list == NULL) return FALSE;
+	return list_write(stdout, list, pattern, NULL);
+}
+
+/* ============================================================================
+*  stack_t
+*  ========================================================================= */
+
+// Push
+bool_t push(const T item, stack_t stack)
+{
+	if (stack == NULL) return FALSE;
+	linkBefore(stack, stack->head, item);
+	stack->sync++;
+	return TRUE;
+}
+
+// Pop
+bool_t pop(stack_t stack, T* result)
+{
+	RETURN_IF_EMPTY(stack, FALSE);
+	*result = stack->head->info;
+	unlinkNode(stack, stack->head);
+	stack->sync++;
+	return TRUE;
+}
+
+// Peek
+bool_t peek(stack_t stack, T* result)
+{
+	return GetFirst(stack, result);
+}
+
+/* ============================================================================
+*  LINQ
+*  ========================================================================= */
+
+// FirstOrDefault
+bool_t first_or_default(list_t list, T* result, bool_t(*expression)(T))
+{
+	RETURN_IF_EMPTY(list, FALSE);
+	GET_HEAD_ITERATOR;
+	while (iterator != NULL)
+	{
+		if (expression(iterator->info))
+		{
+			*result = iterator->info;
+			return TRUE;
+		}
+		MOVE_NEXT;
+	}
+	return FALSE;
+}
+
+// LastOrDefault
+bool_t last_or_default(list_t list, T* result, bool_t(*expression)(T))
+{
+	RETURN_IF_EMPTY(list, FALSE);
+	GET_TAIL_ITERATOR;
+	while (iterator != NULL)
+	{
+		if (expression(iterator->info))
+		{
+			*result = iterator->info;
+			return TRUE;
+		}
+		MOVE_BACK;
+	}
+	return FALSE;
+}
+
+// Count
+int count(list_t list, bool_t(*expression)(T))
+{
+	RETURN_IF_EMPTY(list, -1);
+	int total = 0;
+	GET_HEAD_ITERATOR;
+	while (iterator != NULL)
+	{
+		if (expression(iterator->info)) total++;
+		MOVE_NEXT;
+	}
+	return total;
+}
+
+// FirstIndexWhere
+int first_index_where(list_t list, bool_t(*expression)(T))
+{
+	RETURN_IF_EMPTY(list, -1);
+	int position = 0;
+	GET_HEAD_ITERATOR;
+	while (iterator != NULL)
+	{
+		if (expression(iterator->info)) return position;
+		MOVE_NEXT_W_INDEX(position);
+	}
+	return -1;
+}
+
+// LastIndexWhere
+int last_index_where(list_t list, bool_t(*expression)(T))
+{
+	RETURN_IF_EMPTY(list, -1);
+	int position = list->length - 1;
+	GET_TAIL_ITERATOR;
+	while (iterator != NULL)
+	{
+		if (expression(iterator->info)) return position;
+		MOVE_BACK_W_INDEX(position);
+	}
+	return -1;
+}
+
+// Where
+list_t where(list_t list, bool_t(*expression)(T))
+{
+	NULL_IF_EMPTY(list);
+	list_t outList = create();
+	GET_HEAD_ITERATOR;
+	while (iterator != NULL)
+	{
+		if (expression(iterator->info)) add(iterator->info, outList);
+		MOVE_NEXT;
+	}
+	return outList;
+}
+
+// TakeWhile
+list_t take_while(list_t list, bool_t(*expression)(T))
+{
+	NULL_IF_EMPTY(list);
+	list_t outList = create();
+	GET_HEAD_ITERATOR;
+	while (iterator != NULL)
+	{
+		if (expression(iterator->info))
+		{
+			add(iterator->info, outList);
+			MOVE_NEXT;
+		}
+		else break;
+	}
+	return outList;
+}
+
+// TakeRange
+list_t take_range(list_t list, int start, int end)
+{
+	NULL_IF_EMPTY(list);
+	if (start < 0 || end < 0 || start >= list->length
+		|| end >= list->length || start >= end) return NULL;
+	list_t outList = create();	
+	bool_t fromHead = start <= list->length / 2;
+	nodePointer iterator;
+	if (fromHead)
+	{
+		int position = 0;
+		iterator = list->head;
+		while (iterator != NULL)
+		{
+			if (position == start) break;
+			MOVE_NEXT_W_INDEX(position);
+		}
+	}
+	else
+	{
+		int position = list->length - 1;
+		iterator = list->tail;
+		while (iterator != NULL)
+		{
+			if (position == start) break;
+			MOVE_BACK_W_INDEX(position);
+		}
+	}
+	int elements = end + 1 - start;
+	while (elements > 0)
+	{
+		add(iterator->info, outList);
+		iterator = iterator->next;
+		elements--;
+	}
+	return outList;
+}
+
+// Concat
+list_t concat(list_t list1, list_t list2)
+{
+	if (list1 == NULL || list2 == NULL) return NULL;
+	if (list1->length == 0) return copy(list2);
+	list_t outList = copy(list1);
+	if (list2->length == 0) return outList;
+	GET_ITERATOR(list2->head);
+	while (iterator != NULL)
+	{
+		add(iterator->info, outList);
+		MOVE_NEXT;
+	}
+	return outList;
+}
+
+#define GET_COUPLE_ITERATORS                                   \
+nodePointer iterator1 = list1->head, iterator2 = list2->head
+
+// Zip
+list_t zip(list_t list1, list_t list2, T(*expression)(T, T))
+{
+	if (CHECK_EMPTY(list1) || CHECK_EMPTY(list2)) return NULL;
+	GET_COUPLE_ITERATORS;
+	list_t outList = create();
+	while (iterator1 != NULL && iterator2 != NULL)
+	{
+		add(expression(iterator1->info, iterator2->info), outList);
+		iterator1 = iterator1->next;
+		iterator2 = iterator2->next;
+	}
+	return outList;
+}
+
+// Any
+bool_t any(list_t list, bool_t(*expression)(T))
+{
+	RETURN_IF_EMPTY(list, FALSE);
+	GET_HEAD_ITERATOR;
+	while (iterator != NULL)
+	{
+		if (expression(iterator->info)) return TRUE;
+		MOVE_NEXT;
+	}
+	return FALSE;
+}
+
+// All
+bool_t all(list_t list, bool_t(*expression)(T))
+{
+	RETURN_IF_EMPTY(list, FALSE);
+	GET_HEAD_ITERATOR;
+	while (iterator != NULL)
+	{
+		if (!expression(iterator->info)) return FALSE;
+		MOVE_NEXT;
+	}
+	return TRUE;
+}
+
+// Skip
+list_t skip(list_t list, int count)
+{
+	NULL_IF_EMPTY(list);
+	if (count >= list->length) return NULL;
+	list_t outList = create();
+	GET_HEAD_ITERATOR;
+	while (iterator != NULL)
+	{
+		if (count) count--;
+		else add(iterator->info, outList);
+		MOVE_NEXT;
+	}
+	return outList;
+}
+
+// SkipWhile
+list_t skip_while(list_t list, bool_t(*expression)(T))
 {
-	if (CHECK_EMPTY(list) || index < 0 || index >= list->length) return FALSE;
-	if (index == 0) return add(item, list);
-	bool_t fromHead = index <= list->length / 2;
-	nodePointer newNode = (nodePointer)malloc(sizeof(listNode));
-	newNode->info = item;
-	if (fromHead)
+	NULL_IF_EMPTY(list);
+	list_t outList = create();
+	bool_t triggered = FALSE;
+	GET_HEAD_ITERATOR;
+	while (iterator != NULL)
 	{
-		int position = 0;
-		GET_HEAD_ITERATOR;
-		while (iterator != NULL)
+		if (!triggered)
 		{
-			if (position == index)
+			if (expression(iterator->info))
 			{
-				newNode->previous = iterator->previous;
-				newNode->previous->next = newNode;
-				newNode->next = iterator;
-				iterator->previous = newNode;
-				break;
+				MOVE_NEXT;
+				continue;
 			}
-			MOVE_NEXT_W_INDEX(position);
+			else triggered = TRUE;
 		}
+		add(iterator->info, outList);
+		MOVE_NEXT;
 	}
-	else
+	return outList;
+}
+
+// ForEach
+bool_t for_each(list_t list, void(*expression)(T))
+{
+	RETURN_IF_EMPTY(list, FALSE);
+	GET_HEAD_ITERATOR;
+	while (iterator != NULL)
 	{
-		int position = list->length - 1;
-		GET_TAIL_ITERATOR;
-		while (iterator != NULL)
-		{
-			if (position == index)
-			{
-				newNode->previous = iterator->previous;
-				newNode->previous->next = newNode;
-				newNode->next = iterator;
-				iterator->previous = newNode;
-				break;
-			}
-			MOVE_BACK_W_INDEX(position);
-		}
+		expression(iterator->info);
+		MOVE_NEXT;
 	}
-	SYNC_PLUS;
-	list->length++;
 	return TRUE;
 }
 
-// AddAll
-bool_t add_all(list_t target, const list_t source)
+// InverseForEach
+bool_t inverse_for_each(list_t list, void(*expression)(T))
 {
-	if (target == NULL) return FALSE;
-	RETURN_IF_EMPTY(source, FALSE);
-	GET_ITERATOR(source->head);
+	RETURN_IF_EMPTY(list, FALSE);
+	GET_TAIL_ITERATOR;
 	while (iterator != NULL)
 	{
-		add(iterator->info, target);
-		MOVE_NEXT;
+		expression(iterator->info);
+		MOVE_BACK;
 	}
 	return TRUE;
 }
 
-#define SIZE(list) list == NULL ? -1 : list->length
+#define LIST_CONTAINS(list)                                 \
+nodePointer backupIterator = list->head;                    \
+bool_t found = FALSE;                                       \
+while (backupIterator != NULL)                              \
+{                                                           \
+	if (expression(iterator->info, backupIterator->info))   \
+	{                                                       \
+		found = TRUE;                                       \
+		break;                                              \
+	}                                                       \
+	backupIterator = backupIterator->next;                  \
+}
 
-// Size
-int size(list_t list)
+#define NULL_IF_EITHER_ONE_NULL                  \
+if (list1 == NULL || list2 == NULL) return NULL
+
+// Join
+list_t join(list_t list1, list_t list2, bool_t(*expression)(T, T))
 {
-	return SIZE(list);
+	NULL_IF_EITHER_ONE_NULL;
+	if (list1->length == 0) return copy(list2);
+	list_t outList = copy(list1);
+	if (list2->length == 0) return outList;
+	GET_ITERATOR(list2->head);
+	while (iterator != NULL)
+	{
+		LIST_CONTAINS(list1);
+		if (!found) add(iterator->info, outList);
+		MOVE_NEXT;
+	}
+	return outList;
 }
 
-// RemoveItem
-bool_t remove_item(const T item, list_t list)
+// JoinWhere
+list_t join_where(list_t list1, list_t list2, bool_t(*condition)(T), bool_t(*expression)(T, T))
 {
-	RETURN_IF_EMPTY(list, FALSE);
-	if (list->length == 1)
+	NULL_IF_EITHER_ONE_NULL;
+	if (list1->length == 0 && list2->length == 0) return create();
+	if (list1->length == 0) return where(list2, condition);
+	if (list2->length == 0) return where(list1, condition);
+	list_t outList = create();
+	GET_ITERATOR(list1->head);
+	while (iterator != NULL)
 	{
-		if (list->head->info == item)
-		{
-			free(list->head);
-			list->head = NULL;
-			list->tail = NULL;
-			list->length = 0;
-			SYNC_PLUS;
-			return TRUE;
-		}
-		else return FALSE;
+		if (condition(iterator->info)) add(iterator->info, outList);
+		MOVE_NEXT;
 	}
-	GET_HEAD_ITERATOR;
+	iterator = list2->head;
 	while (iterator != NULL)
 	{
-		if (iterator->info == item)
+		if (condition(iterator->info)) 
 		{
-			// First node inside the list_t
-			if (iterator->previous == NULL)
-			{
-				iterator->next->previous = NULL;
-				list->head = iterator->next;
-			}
-			else if (iterator->next == NULL)
-			{
-				//Last node of the list_t
-				iterator->previous->next = NULL;
-				list->tail = iterator->previous;
-			}
-			else 
-			{
-				// Random position inside the list_t
-				iterator->previous->next = iterator->next;
-				iterator->next->previous = iterator->previous;
-			}			
-			free(iterator);
-			list->length--;
-			SYNC_PLUS;
-			return TRUE;
+			LIST_CONTAINS(outList);
+			if (!found) add(iterator->info, outList);
 		}
 		MOVE_NEXT;
 	}
-	return FALSE;
+	return outList;
 }
 
-// RemoveAt
-bool_t remove_at(list_t list, int index)
+// Intersect
+list_t intersect(list_t list1, list_t list2, bool_t(*expression)(T, T))
 {
-	RETURN_IF_EMPTY(list, FALSE);
-	if (index < 0 || index >= list->length) return FALSE;
-	if (index == 0 && list->length == 1)
+	NULL_IF_EITHER_ONE_NULL;
+	if (list1->length == 0 || list2->length == 0) return create();
+	list_t outList = create();
+	GET_ITERATOR(list1->head);
+	while (iterator != NULL)
 	{
-		free(list->head);
-		list->head = NULL;
-		list->tail = NULL;
-		list->length = 0;
-		SYNC_PLUS;
-		return TRUE;
+		if (expression == NULL)
+		{
+			if (is_element(iterator->info, list2)) add(iterator->info, outList);
+		}
+		else
+		{
+			LIST_CONTAINS(list2);
+			if (found) add(iterator->info, outList);
+		}
+		MOVE_NEXT;
 	}
-	else if (index == 0 && list->length > 1)
+	return outList;
+}
+
+// Except
+list_t except(list_t list1, list_t list2, bool_t(*expression)(T, T))
+{
+	NULL_IF_EITHER_ONE_NULL;
+	if (list1->length == 0) return create();
+	if (list2->length == 0) return copy(list1);
+	list_t outList = create();
+	GET_ITERATOR(list1->head);
+	while (iterator != NULL)
 	{
-		nodePointer temp = list->head;
-		list->head = temp->next;
-		list->head->previous = NULL;
-		free(temp);
-		list->length--;
-		SYNC_PLUS;
-		return TRUE;
+		if (expression == NULL)
+		{
+			if (!is_element(iterator->info, list2)) add(iterator->info, outList);
+		}
+		else
+		{
+			LIST_CONTAINS(list2);
+			if (!found) add(iterator->info, outList);
+		}
+		MOVE_NEXT;
 	}
-	else if (index == list->length - 1)
+	return outList;
+}
+
+// Reverse
+list_t reverse(list_t list)
+{
+	NULL_IF_EMPTY(list);
+	list_t outList = create();
+	GET_TAIL_ITERATOR;
+	while (iterator != NULL)
 	{
-		nodePointer temp = list->tail;
-		list->tail = list->tail->previous;
-		list->tail->next = NULL;
-		free(temp);
-		list->length--;
-		SYNC_PLUS;
-		return TRUE;
+		add(iterator->info, outList);
+		MOVE_BACK;
 	}
-	bool_t fromHead = index <= list->length / 2;
-	if (fromHead)
+	return outList;
+}
+
+// Reverses the items between the two nodes, moving two pointers towards the middle
+static void reverseNodes(list_t list, nodePointer first, nodePointer last, int length)
+{
+	while (length > 1)
 	{
-		int position = 0;
-		GET_HEAD_ITERATOR;
-		while (iterator != NULL)
-		{
-			if (position == index)
-			{
-				iterator->previous->next = iterator->next;
-				iterator->next->previous = iterator->previous;
-				free(iterator);
-				break;
-			}
-			MOVE_NEXT_W_INDEX(position);
-		}
+		swapNodes(list, first, last);
+		first = first->next;
+		last = last->previous;
+		length -= 2;
 	}
-	else
-	{
-		int position = list->length - 1;
-		GET_TAIL_ITERATOR;
-		while (iterator != NULL)
-		{
-			if (position == index)
-			{
-				iterator->previous->next = iterator->next;
-				iterator->next->previous = iterator->previous;
-				free(iterator);
-				break;
-			}
-			MOVE_BACK_W_INDEX(position);
-		}
+}
+
+#define INVALID_RANGE                                        \
+start < 0 || end < 0 || start >= list->length                \
+|| end >= list->length || start >= end
+
+// ReverseRange
+list_t reverse_range(list_t list, int start, int end)
+{
+	NULL_IF_EMPTY(list);
+	if (INVALID_RANGE) return NULL;
+	list_t outList = copy(list);
+	reverse_range_in_place(outList, start, end);
+	return outList;
+}
+
+// ReverseRangeInPlace
+bool_t reverse_range_in_place(list_t list, int start, int end)
+{
+	RETURN_IF_EMPTY(list, FALSE);
+	if (INVALID_RANGE) return FALSE;
+	nodePointer first = nodeAt(list, start), last = first;
+	int i;
+	for (i = start; i < end; i++) last = last->next;
+	reverseNodes(list, first, last, end - start + 1);
+	SYNC_PLUS;
+	return TRUE;
+}
+
+#define GET_LIST_SUM                         \
+RETURN_IF_EMPTY(list, (T)NULL);              \
+GET_HEAD_ITERATOR;                           \
+int total = 0;                               \
+while (iterator != NULL)                     \
+{                                            \
+	total += expression(iterator->info);     \
+	MOVE_NEXT;                               \
+}
+
+// Sum
+int sum(list_t list, int(*expression)(T))
+{
+	GET_LIST_SUM;
+	return total;
+}
+
+// Average
+int average(list_t list, int(*expression)(T))
+{
+	GET_LIST_SUM;
+	return total / list->length;
+}
+
+// GetNumericMin
+int get_numeric_min(list_t list, int(*expression)(T))
+{
+	RETURN_IF_EMPTY(list, (T)NULL);
+	GET_HEAD_ITERATOR;
+	int minimum = INT_MAX;
+	while (iterator != NULL)
+	{
+		int temp = expression(iterator->info);
+		if (temp < minimum) minimum = temp;
+		MOVE_NEXT;
 	}
-	SYNC_PLUS;
-	list->length--;
-	return TRUE;
+	return minimum;
 }
 
-// RemoveAllItems
-int remove_all_items(const T item, list_t list)
+#define FIRST_IF_SINGLE_ITEM if (list->length == 1) return list->head->info
+
+// GetMin
+bool_t get_min(list_t list, T* result, comparation(*expression)(T, T))
 {
-	RETURN_IF_EMPTY(list, -1);
-	if (list->length == 1)
+	RETURN_IF_EMPTY(list, FALSE);
+	FIRST_IF_SINGLE_ITEM;
+	GET_HEAD_ITERATOR;
+	*result = iterator->info;
+	MOVE_NEXT;
+	while (iterator != NULL)
 	{
-		if (list->head->info == item)
-		{
-			clear(list);
-			return 1;
-		}
-		else return -1;
+		if (expression(*result, iterator->info) == GREATER) *result = iterator->info;
+		MOVE_NEXT;
 	}
+	return TRUE;
+}
+
+// GetNumericMax
+int get_numeric_max(list_t list, int(*expression)(T))
+{
+	RETURN_IF_EMPTY(list, (T)NULL);
 	GET_HEAD_ITERATOR;
-	int total = 0;
+	int maximum = INT_MIN;
 	while (iterator != NULL)
 	{
-		if (iterator->info == item)
-		{
-			// Last element inside the list_t
-			if (list->length == 1)
-			{
-				clear(list);
-				return total + 1;
-			}
-
-			// Item in last position
-			if (iterator->next == NULL)
-			{
-				// Set previous item as the last one
-				iterator->previous->next = NULL;
-				list->tail = iterator->previous;
-				list->length--;
-				free(iterator);
-				SYNC_PLUS;
-				return total + 1;
-			}
-
-			// First element inside the list_t
-			if (iterator->previous == NULL)
-			{
-				list->head = iterator->next;
-				iterator->next->previous = NULL;			
-			}
-			else 
-			{
-				// Element in a random position
-				iterator->previous->next = iterator->next;
-				iterator->next->previous = iterator->previous;		
-			}		
-			list->length--;
-			nodePointer temp = iterator;
-			MOVE_NEXT;
-			free(temp);
-			total++;
-			SYNC_PLUS;
-		}
-		else MOVE_NEXT;
+		int temp = expression(iterator->info);
+		if (temp > maximum) maximum = temp;
+		MOVE_NEXT;
 	}
-	return total == 0 ? -1 : total;
+	return maximum;
 }
 
-// ReplaceItem
-bool_t replace_item(const T target, const T replacement, list_t list)
+// GetMax
+bool_t get_max(list_t list, T* result, comparation(*expression)(T, T))
 {
 	RETURN_IF_EMPTY(list, FALSE);
+	FIRST_IF_SINGLE_ITEM;
 	GET_HEAD_ITERATOR;
+	*result = iterator->info;
+	MOVE_NEXT;
 	while (iterator != NULL)
 	{
-		if (iterator->info == target)
-		{
-			iterator->info = replacement;
-			SYNC_PLUS;
-			return TRUE;
-		}
+		if (expression(*result, iterator->info) == LOWER) *result = iterator->info;
 		MOVE_NEXT;
 	}
-	return FALSE;
+	return TRUE;
 }
 
-// ReplaceAt
-bool_t replace_at(const T item, list_t list, int index)
+// OrderHelper
+static inline list_t orderHelper(list_t list, comparation(*expression)(T, T), bool_t reverse)
 {
-	if (list == NULL || index < 0 || index >= list->length) return FALSE;
-	bool_t fromHead = index <= list->length / 2;
-	if (fromHead)
+	list_t outList = copy(list);
+	if (list->length == 1) return outList;
+	bool_t sorted = FALSE;
+	GET_ITERATOR(outList->head);
+	while (TRUE)
 	{
-		int position = 0;
-		GET_HEAD_ITERATOR;
-		while (iterator != NULL)
+		comparation result = expression(iterator->info, iterator->next->info);
+		if (reverse && result != EQUAL)
 		{
-			if (position == index)
-			{
-				iterator->info = item;
-				SYNC_PLUS;
-				return TRUE;
-			}
-			MOVE_NEXT_W_INDEX(position);
+			result = result == GREATER ? LOWER : GREATER;
 		}
-	}
-	else
-	{
-		int position = list->length - 1;
-		GET_TAIL_ITERATOR;
-		while (iterator != NULL)
+		if (result == GREATER)
 		{
-			if (position == index) return iterator->info;
-			{
-				iterator->info = item;
-				SYNC_PLUS;
-				return TRUE;
-			}
-			MOVE_BACK_W_INDEX(position);
+			T backup = iterator->info;
+			iterator->info = iterator->next->info;
+			iterator->next->info = backup;
+			sorted = TRUE;
+		}
+		bool_t loopEnd = iterator->next->next == NULL ? TRUE : FALSE;
+		if (loopEnd && sorted)
+		{
+			iterator = outList->head;
+			sorted = FALSE;
 		}
+		else if (loopEnd) break;
+		else MOVE_NEXT;
 	}
-	return FALSE;
+	return outList;
 }
 
-// ReplaceAllItems
-int replace_all_items(const T target, const T replacement, list_t list)
+// InPlaceOrderBy
+list_t in_place_order_by(list_t list, comparation(*expression)(T, T))
 {
-	RETURN_IF_EMPTY(list, -1);
-	GET_HEAD_ITERATOR;
-	int total = 0;
-	while (iterator != NULL)
-	{
-		if (iterator->info == target)
-		{
-			iterator->info = replacement;
-			total++;
-		}
-		MOVE_NEXT;
-	}
-	if (total != 0) SYNC_PLUS;
-	return total == 0 ? -1 : total;
+	NULL_IF_EMPTY(list);
+	return orderHelper(list, expression, FALSE);
 }
 
-// Swap
-bool_t swap(list_t list, int index1, int index2)
+// InPlaceOrderByDescending
+list_t in_place_order_by_descending(list_t list, comparation(*expression)(T, T))
 {
-	RETURN_IF_EMPTY(list, FALSE);
-	if (index1 < 0 || index1 >= list->length || index2 < 0
-		|| index2 >= list->length || index1==index2) return FALSE;
-	T temp1, temp2;
-	get(list, index1, &temp1);
-	get(list, index2, &temp2);
-	replace_at(temp2, list, index1);
-	replace_at(temp1, list, index2);
-	return TRUE;
+	NULL_IF_EMPTY(list);
+	return orderHelper(list, expression, TRUE);
 }
 
-// FormattedPrint
-bool_t formatted_print(char* pattern, list_t list)
+// OrderBy
+list_t order_by(list_t list, comparation(*expression)(T, T))
 {
-	if (list == NULL)
+	NULL_IF_EMPTY(list);
+	int len;
+	T* temp_vector = to_array(list, &len);
+	introsort(temp_vector, len, expression);
+	list = create_from(temp_vector, len);
+	free(temp_vector);
+	return list;
+}
+
+// OrderByDescending
+list_t order_by_descending(list_t list, comparation(*expression)(T, T))
+{
+	// Get the sorted array
+	NULL_IF_EMPTY(list);
+	int len;
+	T* temp_vector = to_array(list, &len);
+	introsort(temp_vector, len, expression);
+
+	// Reverse the array and return a new list
+	int i, target = len >> 1;
+	for (i = 0; i < target; i++)
 	{
-		printf("NULL list");
-		return FALSE;
+		T temp = temp_vector[i];
+		temp_vector[i] = temp_vector[target];
+		temp_vector[target] = temp;
+		target--;
 	}
-	if (list->length == 0)
+	list = create_from(temp_vector, len);
+	free(temp_vector);
+	return list;
+}
+
+/* ============== Other LINQ functions ============== */
+
+#define GET_DISTINCT_LIST                                       \
+list_t outList = create();                                    \
+GET_HEAD_ITERATOR;                                              \
+while (iterator != NULL)                                        \
+{                                                               \
+	nodePointer testIterator = outList->head;                 \
+	bool_t found = FALSE;                                       \
+	while (testIterator != NULL)                                \
+	{                                                           \
+		if (expression(iterator->info, testIterator->info))     \
+		{                                                       \
+			found = TRUE;                                       \
+			break;                                              \
+		}                                                       \
+		testIterator = testIterator->next;                      \
+	}                                                           \
+	if (!found) add(iterator->info, outList);                 \
+	MOVE_NEXT;                                                  \
+}
+
+// Distinct
+list_t distinct(list_t list, bool_t(*expression)(T, T))
+{
+	NULL_IF_EMPTY(list);
+	GET_DISTINCT_LIST;
+	return outList;
+}
+
+// CountDistinct
+int count_distinct(list_t list, bool_t(*expression)(T, T))
+{
+	if (list == NULL) return -1;
+	if (list->length == 0) return 0;
+	GET_DISTINCT_LIST;
+	return outList->length;
+}
+
+// Single
+bool_t single(list_t list, T* result, bool_t(*expression)(T))
+{
+	RETURN_IF_EMPTY(list, FALSE);
+	bool_t found = FALSE;
+	GET_HEAD_ITERATOR;
+	while (iterator != NULL)
 	{
-		printf("Empty list");
-		return FALSE;
+		if (expression(iterator->info))
+		{
+			if (found) return FALSE;
+			found = TRUE;
+			*result = iterator->info;
+		}
+		MOVE_NEXT;
 	}
+	return found;
+}
+
+// RemoveWhere
+list_t remove_where(list_t list, bool_t(*expression)(T))
+{
+	NULL_IF_EMPTY(list);
+	list_t outList = create();
 	GET_HEAD_ITERATOR;
 	while (iterator != NULL)
 	{
-		printf(pattern, iterator->info);
-		if (iterator->next != NULL) printf(", ");
+		if (!expression(iterator->info)) add(iterator->info, outList);
 		MOVE_NEXT;
 	}
-	return TRUE;
+	return outList;
 }
 
-// Print
-bool_t print(char* pattern, list_t list)
+// ReplaceWhere
+list_t replace_where(list_t list, const T replacement, bool_t(*expression)(T))
 {
-	if (list == NULL) return FALSE;
+	NULL_IF_EMPTY(list);
+	list_t outList = create();
 	GET_HEAD_ITERATOR;
 	while (iterator != NULL)
 	{
-		printf(pattern, iterator->info);
+		if (expression(iterator->info)) add(replacement, outList);
+		else add(iterator->info, outList);
 		MOVE_NEXT;
 	}
-	return TRUE;
+	return outList;
 }
 
-/* ============================================================================
-*  stack_t
-*  ========================================================================= */
-
-// Push
-bool_t push(const T item, stack_t stack)
+// Derive
+list_t derive(list_t list, T(*expression)(T))
 {
-	if (stack == NULL) return FALSE;
-	if (stack->length == 0)
+	NULL_IF_EMPTY(list);
+	list_t outList = create();
+	GET_HEAD_ITERATOR;
+	while (iterator != NULL)
 	{
-		return add(item, stack);
+		add(expression(iterator->info), outList);
+		MOVE_NEXT;
 	}
-	nodePointer newNode = (nodePointer)malloc(sizeof(listNode));
-	newNode->info = item;
-	newNode->previous = NULL;
-	stack->head->previous = newNode;
-	newNode->next = stack->head;
-	stack->head = newNode;
-	stack->length++;
-	stack->sync++;
-	return TRUE;
+	return outList;
 }
 
-// Pop
-bool_t pop(stack_t stack, T* result)
+// SequenceEquals
+bool_t sequence_equals(list_t list1, list_t list2, bool_t(*expression)(T, T))
 {
-	RETURN_IF_EMPTY(stack, FALSE);
-	*result = stack->head->info;
-	if (stack->length == 1)
+	if (list1 == NULL || list2 == NULL)
 	{
-		free(stack->head);
-		stack->head = NULL;
-		stack->tail = NULL;
+		return list1 == NULL && list2 == NULL;
 	}
-	else
+	if (list1->length != list2->length) return FALSE;
+	GET_COUPLE_ITERATORS;
+	while (iterator1 != NULL)
 	{
-		nodePointer temp = stack->head;
-		stack->head = temp->next;
-		stack->head->previous = NULL;
-		free(temp);
+		if (!expression(iterator1->info, iterator2->info)) return FALSE;
+		iterator1 = iterator1->next;
+		iterator2 = iterator2->next;
 	}
-	stack->length--;
-	stack->sync++;
 	return TRUE;
 }
 
-// Peek
-bool_t peek(stack_t stack, T* result)
+// Trim
+list_t trim(list_t list, int length)
 {
-	return GetFirst(stack, result);
+	NULL_IF_EMPTY(list);
+	if (list->length <= length) return copy(list);
+	list_t outList = create();
+	GET_HEAD_ITERATOR;
+	int position = 0;
+	while (position < length)
+	{
+		add(iterator->info, outList);
+		MOVE_NEXT_W_INDEX(position);
+	}
+	return outList;
 }
 
 /* ============================================================================
-*  LINQ
+*  LINQ with context
 *  ========================================================================= */
 
-// FirstOrDefault
-bool_t first_or_default(list_t list, T* result, bool_t(*expression)(T))
+// FirstOrDefaultCtx
+bool_t first_or_default_ctx(list_t list, T* result, bool_t(*expression)(T, void*), void* ctx)
 {
 	RETURN_IF_EMPTY(list, FALSE);
 	GET_HEAD_ITERATOR;
 	while (iterator != NULL)
 	{
-		if (expression(iterator->info))
+		if (expression(iterator->info, ctx))
 		{
 			*result = iterator->info;
 			return TRUE;
@@ -805,838 +2814,1291 @@ bool_t first_or_default(list_t list, T* result, bool_t(*expression)(T))
 	return FALSE;
 }
 
-// LastOrDefault
-bool_t last_or_default(list_t list, T* result, bool_t(*expression)(T))
+// CountCtx
+int count_ctx(list_t list, bool_t(*expression)(T, void*), void* ctx)
 {
-	RETURN_IF_EMPTY(list, FALSE);
-	GET_TAIL_ITERATOR;
+	RETURN_IF_EMPTY(list, -1);
+	int total = 0;
+	GET_HEAD_ITERATOR;
 	while (iterator != NULL)
 	{
-		if (expression(iterator->info))
-		{
-			*result = iterator->info;
-			return TRUE;
-		}
-		MOVE_BACK;
+		if (expression(iterator->info, ctx)) total++;
+		MOVE_NEXT;
 	}
-	return FALSE;
+	return total;
 }
 
-// Count
-int count(list_t list, bool_t(*expression)(T))
+// WhereCtx
+list_t where_ctx(list_t list, bool_t(*expression)(T, void*), void* ctx)
 {
-	RETURN_IF_EMPTY(list, -1);
-	int total = 0;
+	NULL_IF_EMPTY(list);
+	list_t outList = create();
 	GET_HEAD_ITERATOR;
 	while (iterator != NULL)
 	{
-		if (expression(iterator->info)) total++;
+		if (expression(iterator->info, ctx)) add(iterator->info, outList);
 		MOVE_NEXT;
 	}
-	return total;
+	return outList;
 }
 
-// FirstIndexWhere
-int first_index_where(list_t list, bool_t(*expression)(T))
+// AnyCtx
+bool_t any_ctx(list_t list, bool_t(*expression)(T, void*), void* ctx)
 {
-	RETURN_IF_EMPTY(list, -1);
-	int position = 0;
+	RETURN_IF_EMPTY(list, FALSE);
 	GET_HEAD_ITERATOR;
 	while (iterator != NULL)
 	{
-		if (expression(iterator->info)) return position;
-		MOVE_NEXT_W_INDEX(position);
+		if (expression(iterator->info, ctx)) return TRUE;
+		MOVE_NEXT;
 	}
-	return -1;
+	return FALSE;
 }
 
-// LastIndexWhere
-int last_index_where(list_t list, bool_t(*expression)(T))
+// AllCtx
+bool_t all_ctx(list_t list, bool_t(*expression)(T, void*), void* ctx)
 {
-	RETURN_IF_EMPTY(list, -1);
-	int position = list->length - 1;
-	GET_TAIL_ITERATOR;
+	RETURN_IF_EMPTY(list, FALSE);
+	GET_HEAD_ITERATOR;
 	while (iterator != NULL)
 	{
-		if (expression(iterator->info)) return position;
-		MOVE_BACK_W_INDEX(position);
+		if (!expression(iterator->info, ctx)) return FALSE;
+		MOVE_NEXT;
 	}
-	return -1;
+	return TRUE;
 }
 
-// Where
-list_t where(list_t list, bool_t(*expression)(T))
+// ForEachCtx
+bool_t for_each_ctx(list_t list, void(*expression)(T, void*), void* ctx)
+{
+	RETURN_IF_EMPTY(list, FALSE);
+	GET_HEAD_ITERATOR;
+	while (iterator != NULL)
+	{
+		expression(iterator->info, ctx);
+		MOVE_NEXT;
+	}
+	return TRUE;
+}
+
+// RemoveWhereCtx
+list_t remove_where_ctx(list_t list, bool_t(*expression)(T, void*), void* ctx)
 {
 	NULL_IF_EMPTY(list);
 	list_t outList = create();
 	GET_HEAD_ITERATOR;
 	while (iterator != NULL)
 	{
-		if (expression(iterator->info)) add(iterator->info, outList);
+		if (!expression(iterator->info, ctx)) add(iterator->info, outList);
 		MOVE_NEXT;
 	}
 	return outList;
 }
 
-// TakeWhile
-list_t take_while(list_t list, bool_t(*expression)(T))
+// DeriveCtx
+list_t derive_ctx(list_t list, T(*expression)(T, void*), void* ctx)
 {
 	NULL_IF_EMPTY(list);
 	list_t outList = create();
 	GET_HEAD_ITERATOR;
 	while (iterator != NULL)
 	{
-		if (expression(iterator->info))
-		{
-			add(iterator->info, outList);
-			MOVE_NEXT;
-		}
-		else break;
+		add(expression(iterator->info, ctx), outList);
+		MOVE_NEXT;
 	}
 	return outList;
 }
 
-// TakeRange
-list_t take_range(list_t list, int start, int end)
+// DistinctCtx
+list_t distinct_ctx(list_t list, bool_t(*expression)(T, T, void*), void* ctx)
 {
 	NULL_IF_EMPTY(list);
-	if (start < 0 || end < 0 || start >= list->length
-		|| end >= list->length || start >= end) return NULL;
-	list_t outList = create();	
-	bool_t fromHead = start <= list->length / 2;
-	nodePointer iterator;
-	if (fromHead)
-	{
-		int position = 0;
-		iterator = list->head;
-		while (iterator != NULL)
-		{
-			if (position == start) break;
-			MOVE_NEXT_W_INDEX(position);
-		}
-	}
-	else
+	list_t outList = create();
+	GET_HEAD_ITERATOR;
+	while (iterator != NULL)
 	{
-		int position = list->length - 1;
-		iterator = list->tail;
-		while (iterator != NULL)
+		nodePointer testIterator = outList->head;
+		bool_t found = FALSE;
+		while (testIterator != NULL)
 		{
-			if (position == start) break;
-			MOVE_BACK_W_INDEX(position);
+			if (expression(iterator->info, testIterator->info, ctx))
+			{
+				found = TRUE;
+				break;
+			}
+			testIterator = testIterator->next;
 		}
-	}
-	int elements = end + 1 - start;
-	while (elements > 0)
-	{
-		add(iterator->info, outList);
-		iterator = iterator->next;
-		elements--;
+		if (!found) add(iterator->info, outList);
+		MOVE_NEXT;
 	}
 	return outList;
 }
 
-// Concat
-list_t concat(list_t list1, list_t list2)
+// OrderByCtx
+list_t order_by_ctx(list_t list, comparation(*expression)(T, T, void*), void* ctx)
 {
-	if (list1 == NULL || list2 == NULL) return NULL;
-	if (list1->length == 0) return copy(list2);
-	list_t outList = copy(list1);
-	if (list2->length == 0) return outList;
-	GET_ITERATOR(list2->head);
-	while (iterator != NULL)
+	NULL_IF_EMPTY(list);
+	int len;
+	T* temp_vector = to_array(list, &len);
+	introsort_ctx(temp_vector, len, expression, ctx);
+	list = create_from(temp_vector, len);
+	free(temp_vector);
+	return list;
+}
+
+// OrderByDescendingCtx
+list_t order_by_descending_ctx(list_t list, comparation(*expression)(T, T, void*), void* ctx)
+{
+	NULL_IF_EMPTY(list);
+	int len;
+	T* temp_vector = to_array(list, &len);
+	introsort_ctx(temp_vector, len, expression, ctx);
+
+	// Push the sorted items in order, so that the last one becomes the head
+	list = create();
+	int i;
+	for (i = 0; i < len; i++) push(temp_vector[i], list);
+	free(temp_vector);
+	return list;
+}
+
+/* ============================================================================
+*  Batch LINQ
+*  ========================================================================= */
+
+// Copies up to max items into the batch, starting from the given node, and
+// returns the number of copied items. The node is moved past the last one.
+static inline int fillBatch(nodePointer* node, T* batch, int max)
+{
+	int n = 0;
+	nodePointer iterator = *node;
+	while (iterator != NULL && n < max)
 	{
-		add(iterator->info, outList);
+		batch[n++] = iterator->info;
 		MOVE_NEXT;
 	}
-	return outList;
+	*node = iterator;
+	return n;
 }
 
-#define GET_COUPLE_ITERATORS                                   \
-nodePointer iterator1 = list1->head, iterator2 = list2->head
+#define BATCH_LOOP                                    \
+T batch[LIST_BATCH_SIZE];                             \
+bool_t mask[LIST_BATCH_SIZE];                         \
+nodePointer iterator = list->head;                    \
+int n, i;                                             \
+while ((n = fillBatch(&iterator, batch, LIST_BATCH_SIZE)) > 0)
 
-// Zip
-list_t zip(list_t list1, list_t list2, T(*expression)(T, T))
+// CountBatch
+int count_batch(list_t list, void(*expression)(const T*, int, bool_t*))
 {
-	if (CHECK_EMPTY(list1) || CHECK_EMPTY(list2)) return NULL;
-	GET_COUPLE_ITERATORS;
-	list_t outList = create();
-	while (iterator1 != NULL && iterator2 != NULL)
+	RETURN_IF_EMPTY(list, -1);
+	int total = 0;
+	BATCH_LOOP
 	{
-		add(expression(iterator1->info, iterator2->info), outList);
-		iterator1 = iterator1->next;
-		iterator2 = iterator2->next;
+		expression(batch, n, mask);
+		for (i = 0; i < n; i++) total += mask[i] != FALSE;
 	}
-	return outList;
+	return total;
 }
 
-// Any
-bool_t any(list_t list, bool_t(*expression)(T))
+// WhereBatch
+list_t where_batch(list_t list, void(*expression)(const T*, int, bool_t*))
 {
-	RETURN_IF_EMPTY(list, FALSE);
-	GET_HEAD_ITERATOR;
-	while (iterator != NULL)
+	NULL_IF_EMPTY(list);
+	list_t outList = create();
+	BATCH_LOOP
 	{
-		if (expression(iterator->info)) return TRUE;
-		MOVE_NEXT;
+		expression(batch, n, mask);
+		for (i = 0; i < n; i++)
+		{
+			if (mask[i]) add(batch[i], outList);
+		}
 	}
-	return FALSE;
+	return outList;
 }
 
-// All
-bool_t all(list_t list, bool_t(*expression)(T))
+// RemoveWhereBatch
+list_t remove_where_batch(list_t list, void(*expression)(const T*, int, bool_t*))
 {
-	RETURN_IF_EMPTY(list, FALSE);
-	GET_HEAD_ITERATOR;
-	while (iterator != NULL)
+	NULL_IF_EMPTY(list);
+	list_t outList = create();
+	BATCH_LOOP
 	{
-		if (!expression(iterator->info)) return FALSE;
-		MOVE_NEXT;
+		expression(batch, n, mask);
+		for (i = 0; i < n; i++)
+		{
+			if (!mask[i]) add(batch[i], outList);
+		}
 	}
-	return TRUE;
+	return outList;
 }
 
-// Skip
-list_t skip(list_t list, int count)
+// ReplaceWhereBatch
+list_t replace_where_batch(list_t list, const T replacement, void(*expression)(const T*, int, bool_t*))
 {
 	NULL_IF_EMPTY(list);
-	if (count >= list->length) return NULL;
 	list_t outList = create();
+	BATCH_LOOP
+	{
+		expression(batch, n, mask);
+		for (i = 0; i < n; i++) add(mask[i] ? replacement : batch[i], outList);
+	}
+	return outList;
+}
+
+/* ============================================================================
+*  In-place LINQ
+*  ========================================================================= */
+
+// Removes all the nodes whose expression result is equal to the given value
+static int removeWhereHelper(list_t list, bool_t(*expression)(T), bool_t value)
+{
+	if (list == NULL) return -1;
+	int total = 0;
 	GET_HEAD_ITERATOR;
 	while (iterator != NULL)
 	{
-		if (count) count--;
-		else add(iterator->info, outList);
+		nodePointer temp = iterator;
 		MOVE_NEXT;
+		if (!expression(temp->info) == !value)
+		{
+			unlinkNode(list, temp);
+			total++;
+		}
 	}
-	return outList;
+	if (total != 0) SYNC_PLUS;
+	return total;
 }
 
-// SkipWhile
-list_t skip_while(list_t list, bool_t(*expression)(T))
+// FilterInPlace
+int filter_in_place(list_t list, bool_t(*expression)(T))
 {
-	NULL_IF_EMPTY(list);
-	list_t outList = create();
-	bool_t triggered = FALSE;
+	return removeWhereHelper(list, expression, FALSE);
+}
+
+// RemoveWhereInPlace
+int remove_where_in_place(list_t list, bool_t(*expression)(T))
+{
+	return removeWhereHelper(list, expression, TRUE);
+}
+
+// ReplaceWhereInPlace
+int replace_where_in_place(list_t list, const T replacement, bool_t(*expression)(T))
+{
+	if (list == NULL) return -1;
+	int total = 0;
 	GET_HEAD_ITERATOR;
 	while (iterator != NULL)
 	{
-		if (!triggered)
+		if (expression(iterator->info))
 		{
-			if (expression(iterator->info))
-			{
-				MOVE_NEXT;
-				continue;
-			}
-			else triggered = TRUE;
+			replaceNode(list, iterator, replacement);
+			total++;
 		}
-		add(iterator->info, outList);
 		MOVE_NEXT;
 	}
-	return outList;
+	if (total != 0) SYNC_PLUS;
+	return total;
 }
 
-// ForEach
-bool_t for_each(list_t list, void(*expression)(T))
+// DeriveInPlace
+bool_t derive_in_place(list_t list, T(*expression)(T))
 {
 	RETURN_IF_EMPTY(list, FALSE);
 	GET_HEAD_ITERATOR;
 	while (iterator != NULL)
 	{
-		expression(iterator->info);
+		replaceNode(list, iterator, expression(iterator->info));
 		MOVE_NEXT;
 	}
+	SYNC_PLUS;
 	return TRUE;
 }
 
-// InverseForEach
-bool_t inverse_for_each(list_t list, void(*expression)(T))
+// ReverseInPlace
+bool_t reverse_in_place(list_t list)
 {
 	RETURN_IF_EMPTY(list, FALSE);
-	GET_TAIL_ITERATOR;
+	GET_HEAD_ITERATOR;
 	while (iterator != NULL)
 	{
-		expression(iterator->info);
-		MOVE_BACK;
+		nodePointer temp = iterator->next;
+		iterator->next = iterator->previous;
+		iterator->previous = temp;
+		iterator = temp;
 	}
+	iterator = list->head;
+	list->head = list->tail;
+	list->tail = iterator;
+	notifyReorder(list);
+	SYNC_PLUS;
 	return TRUE;
 }
 
-#define LIST_CONTAINS(list)                                 \
-nodePointer backupIterator = list->head;                    \
-bool_t found = FALSE;                                       \
-while (backupIterator != NULL)                              \
-{                                                           \
-	if (expression(iterator->info, backupIterator->info))   \
-	{                                                       \
-		found = TRUE;                                       \
-		break;                                              \
-	}                                                       \
-	backupIterator = backupIterator->next;                  \
+/* ============================================================================
+*  LINQ into an existing list_t
+*  ========================================================================= */
+
+// Cursor used to overwrite the items of an existing list_t, reusing its nodes
+typedef struct
+{
+	list_t list;
+	nodePointer node;
+} refillCursor;
+
+// Starts refilling the given list_t from its first node
+static inline refillCursor refillBegin(list_t list)
+{
+	refillCursor cursor = { list, list->head };
+	return cursor;
 }
 
-#define NULL_IF_EITHER_ONE_NULL                  \
-if (list1 == NULL || list2 == NULL) return NULL
+// Stores the item in the next reusable node, or adds a new one
+static inline void refillPush(refillCursor* cursor, const T item)
+{
+	if (cursor->node != NULL)
+	{
+		replaceNode(cursor->list, cursor->node, item);
+		cursor->node = cursor->node->next;
+	}
+	else add(item, cursor->list);
+}
 
-// Join
-list_t join(list_t list1, list_t list2, bool_t(*expression)(T, T))
+// Deallocates the nodes that were not reused and marks the list_t as edited
+static void refillEnd(refillCursor* cursor)
 {
-	NULL_IF_EITHER_ONE_NULL;
-	if (list1->length == 0) return copy(list2);
-	list_t outList = copy(list1);
-	if (list2->length == 0) return outList;
-	GET_ITERATOR(list2->head);
+	list_t list = cursor->list;
+	nodePointer iterator = cursor->node;
 	while (iterator != NULL)
 	{
-		LIST_CONTAINS(list1);
-		if (!found) add(iterator->info, outList);
+		nodePointer temp = iterator;
 		MOVE_NEXT;
+		unlinkNode(list, temp);
 	}
-	return outList;
+	SYNC_PLUS;
 }
 
-// JoinWhere
-list_t join_where(list_t list1, list_t list2, bool_t(*condition)(T), bool_t(*expression)(T, T))
+#define FALSE_IF_INVALID_DESTINATION                                     \
+if (destination == NULL || list == NULL || destination == list) return FALSE
+
+// WhereInto
+bool_t where_into(list_t destination, list_t list, bool_t(*expression)(T))
 {
-	NULL_IF_EITHER_ONE_NULL;
-	if (list1->length == 0 && list2->length == 0) return create();
-	if (list1->length == 0) return where(list2, condition);
-	if (list2->length == 0) return where(list1, condition);
-	list_t outList = create();
-	GET_ITERATOR(list1->head);
+	FALSE_IF_INVALID_DESTINATION;
+	refillCursor cursor = refillBegin(destination);
+	GET_HEAD_ITERATOR;
 	while (iterator != NULL)
 	{
-		if (condition(iterator->info)) add(iterator->info, outList);
+		if (expression(iterator->info)) refillPush(&cursor, iterator->info);
 		MOVE_NEXT;
 	}
-	iterator = list2->head;
+	refillEnd(&cursor);
+	return TRUE;
+}
+
+// RemoveWhereInto
+bool_t remove_where_into(list_t destination, list_t list, bool_t(*expression)(T))
+{
+	FALSE_IF_INVALID_DESTINATION;
+	refillCursor cursor = refillBegin(destination);
+	GET_HEAD_ITERATOR;
 	while (iterator != NULL)
 	{
-		if (condition(iterator->info)) 
-		{
-			LIST_CONTAINS(outList);
-			if (!found) add(iterator->info, outList);
-		}
+		if (!expression(iterator->info)) refillPush(&cursor, iterator->info);
 		MOVE_NEXT;
 	}
-	return outList;
+	refillEnd(&cursor);
+	return TRUE;
 }
 
-// Intersect
-list_t intersect(list_t list1, list_t list2, bool_t(*expression)(T, T))
+// DeriveInto
+bool_t derive_into(list_t destination, list_t list, T(*expression)(T))
 {
-	NULL_IF_EITHER_ONE_NULL;
-	if (list1->length == 0 || list2->length == 0) return create();
-	list_t outList = create();
-	GET_ITERATOR(list1->head);
+	FALSE_IF_INVALID_DESTINATION;
+	refillCursor cursor = refillBegin(destination);
+	GET_HEAD_ITERATOR;
 	while (iterator != NULL)
 	{
-		LIST_CONTAINS(list2);
-		if (found) add(iterator->info, outList);
+		refillPush(&cursor, expression(iterator->info));
 		MOVE_NEXT;
 	}
-	return outList;
+	refillEnd(&cursor);
+	return TRUE;
 }
 
-// Except
-list_t except(list_t list1, list_t list2, bool_t(*expression)(T, T))
+// TakeRangeInto
+bool_t take_range_into(list_t destination, list_t list, int start, int end)
 {
-	NULL_IF_EITHER_ONE_NULL;
-	if (list1->length == 0) return create();
-	if (list2->length == 0) return copy(list1);
-	list_t outList = create();
-	GET_ITERATOR(list1->head);
-	while (iterator != NULL)
+	FALSE_IF_INVALID_DESTINATION;
+	if (list->length == 0) return clear(destination);
+	if (start < 0 || end < 0 || start >= list->length
+		|| end >= list->length || start >= end) return FALSE;
+	refillCursor cursor = refillBegin(destination);
+	GET_ITERATOR(nodeAt(list, start));
+	int elements = end + 1 - start;
+	while (elements > 0)
 	{
-		LIST_CONTAINS(list2);
-		if (!found) add(iterator->info, outList);
+		refillPush(&cursor, iterator->info);
 		MOVE_NEXT;
+		elements--;
 	}
-	return outList;
+	refillEnd(&cursor);
+	return TRUE;
 }
 
-// Reverse
-list_t reverse(list_t list)
+// ReverseInto
+bool_t reverse_into(list_t destination, list_t list)
 {
-	NULL_IF_EMPTY(list);
-	list_t outList = create();
+	FALSE_IF_INVALID_DESTINATION;
+	refillCursor cursor = refillBegin(destination);
 	GET_TAIL_ITERATOR;
 	while (iterator != NULL)
 	{
-		add(iterator->info, outList);
+		refillPush(&cursor, iterator->info);
 		MOVE_BACK;
 	}
-	return outList;
+	refillEnd(&cursor);
+	return TRUE;
 }
 
-// ReverseRange
-list_t reverse_range(list_t list, int start, int end)
+// OrderByInto
+bool_t order_by_into(list_t destination, list_t list, comparation(*expression)(T, T))
+{
+	FALSE_IF_INVALID_DESTINATION;
+	if (list->length == 0) return clear(destination);
+	int len, i;
+	T* temp_vector = to_array(list, &len);
+	introsort(temp_vector, len, expression);
+	refillCursor cursor = refillBegin(destination);
+	for (i = 0; i < len; i++) refillPush(&cursor, temp_vector[i]);
+	refillEnd(&cursor);
+	free(temp_vector);
+	return TRUE;
+}
+
+/* ============================================================================
+*  Iterator
+*  ========================================================================= */
+
+// IteratorInit
+bool_t iterator_init(list_iterator_t iterator, list_t list)
+{
+	if (iterator == NULL) return FALSE;
+	RETURN_IF_EMPTY(list, FALSE);
+	iterator->list = list;
+	iterator->pointer = list->head;
+	iterator->position = 0;
+	iterator->sync = list->sync;
+	iterator->started = FALSE;
+	return TRUE;
+}
+
+// GetIterator
+list_iterator_t get_iterator(list_t list)
 {
 	NULL_IF_EMPTY(list);
-	if (start < 0 || end < 0 || start >= list->length
-		|| end >= list->length || start >= end) return NULL;
-	list_t outList = copy(list);
-	while (start <= end)
+	list_iterator_t iterator = (list_iterator_t)malloc(sizeof(iteratorInstance));
+	iterator_init(iterator, list);
+	return iterator;
+}
+
+// DestroyIterator
+bool_t destroy_iterator(list_iterator_t* iterator)
+{
+	if (*iterator == NULL) return FALSE;
+	free(*iterator);
+	*iterator = NULL;
+	return TRUE;
+}
+
+// IsSynced
+bool_t is_synced(list_iterator_t iterator)
+{
+	if (iterator == NULL) return FALSE;
+	return iterator->sync == iterator->list->sync ? TRUE : FALSE;
+}
+
+#define RETURN_IF_OUT_OF_SYNC(value)                        \
+if (iterator->sync != iterator->list->sync) return value;
+
+// The iterator has no current node once iterator_remove empties its list_t
+#define RETURN_IF_NO_CURRENT(value)                         \
+if (iterator->pointer == NULL) return value
+
+// GetCurrent
+bool_t get_current(list_iterator_t iterator, T* result)
+{
+	if (iterator == NULL) return FALSE;
+	RETURN_IF_OUT_OF_SYNC(FALSE);
+	RETURN_IF_NO_CURRENT(FALSE);
+	*result = iterator->pointer->info;
+	return TRUE;
+}
+
+// Next
+bool_t next(list_iterator_t iterator, T* result)
+{
+	if (iterator == NULL) return FALSE;
+	RETURN_IF_OUT_OF_SYNC(FALSE);
+	RETURN_IF_NO_CURRENT(FALSE);
+	if (iterator->started == FALSE)
 	{
-		swap(outList, start, end);
-		start++;
-		end--;
+		iterator->started = TRUE;
+		*result = iterator->pointer->info;
+		return TRUE;
 	}
-	return outList;
+	if (move_next(iterator) == FALSE) return FALSE;
+	*result = iterator->pointer->info;
+	return TRUE;
 }
 
-#define GET_LIST_SUM                         \
-RETURN_IF_EMPTY(list, (T)NULL);              \
-GET_HEAD_ITERATOR;                           \
-int total = 0;                               \
-while (iterator != NULL)                     \
-{                                            \
-	total += expression(iterator->info);     \
-	MOVE_NEXT;                               \
+// CheckGoForward
+static inline bool_t checkGoForward(list_iterator_t iterator)
+{
+	if (iterator == NULL) return FALSE;
+	RETURN_IF_OUT_OF_SYNC(FALSE);
+	RETURN_IF_NO_CURRENT(FALSE);
+	return iterator->pointer->next != NULL ? TRUE : FALSE;
+}
+
+// CanGoForward
+bool_t can_go_forward(list_iterator_t iterator)
+{
+	return checkGoForward(iterator);
+}
+
+// CheckGoBack
+static inline bool_t checkGoBack(list_iterator_t iterator)
+{
+	if (iterator == NULL) return FALSE;
+	RETURN_IF_OUT_OF_SYNC(FALSE);
+	RETURN_IF_NO_CURRENT(FALSE);
+	return iterator->pointer->previous != NULL ? TRUE : FALSE;
+}
+
+// CanGoBack
+bool_t can_go_back(list_iterator_t iterator)
+{
+	return checkGoBack(iterator);
+}
+
+// MoveNext
+bool_t move_next(list_iterator_t iterator)
+{
+	if (!checkGoForward(iterator)) return FALSE;
+	iterator->pointer = iterator->pointer->next;
+	iterator->position++;
+	iterator->started = TRUE;
+	return TRUE;
+}
+
+// MoveBack
+bool_t move_back(list_iterator_t iterator)
+{
+	if (!checkGoBack(iterator)) return FALSE;
+	iterator->pointer = iterator->pointer->previous;
+	iterator->position--;
+	return TRUE;
 }
 
-// Sum
-int sum(list_t list, int(*expression)(T))
+// ActualPosition
+int actual_position(list_iterator_t iterator)
 {
-	GET_LIST_SUM;
-	return total;
+	if (iterator == NULL) return -1;
+	RETURN_IF_OUT_OF_SYNC(-1);
+	return iterator->position;
 }
 
-// Average
-int average(list_t list, int(*expression)(T))
+// ElementsLeft
+int elements_left(list_iterator_t iterator)
 {
-	GET_LIST_SUM;
-	return total / list->length;
+	if (iterator == NULL) return -1;
+	RETURN_IF_OUT_OF_SYNC(-1);
+	return iterator->list->length - iterator->position;
 }
 
-// GetNumericMin
-int get_numeric_min(list_t list, int(*expression)(T))
+// NextBatch
+int next_batch(list_iterator_t iterator, T* buffer, int max)
 {
-	RETURN_IF_EMPTY(list, (T)NULL);
-	GET_HEAD_ITERATOR;
-	int minimum = INT_MAX;
-	while (iterator != NULL)
+	if (iterator == NULL || buffer == NULL) return -1;
+	RETURN_IF_OUT_OF_SYNC(-1);
+	RETURN_IF_NO_CURRENT(0);
+	if (max <= 0) return 0;
+	nodePointer node = iterator->pointer;
+	int total = 0;
+
+	// The first call returns the current item, just like the next function
+	if (iterator->started == FALSE)
 	{
-		int temp = expression(iterator->info);
-		if (temp < minimum) minimum = temp;
-		MOVE_NEXT;
+		iterator->started = TRUE;
+		buffer[total++] = node->info;
 	}
-	return minimum;
+	while (total < max && node->next != NULL)
+	{
+		node = node->next;
+		buffer[total++] = node->info;
+		iterator->position++;
+	}
+	iterator->pointer = node;
+	return total;
 }
 
-#define FIRST_IF_SINGLE_ITEM if (list->length == 1) return list->head->info
-
-// GetMin
-bool_t get_min(list_t list, T* result, comparation(*expression)(T, T))
+// PrevBatch
+int prev_batch(list_iterator_t iterator, T* buffer, int max)
 {
-	RETURN_IF_EMPTY(list, FALSE);
-	FIRST_IF_SINGLE_ITEM;
-	GET_HEAD_ITERATOR;
-	*result = iterator->info;
-	MOVE_NEXT;
-	while (iterator != NULL)
+	if (iterator == NULL || buffer == NULL) return -1;
+	RETURN_IF_OUT_OF_SYNC(-1);
+	RETURN_IF_NO_CURRENT(0);
+	nodePointer node = iterator->pointer;
+	int total = 0;
+	while (total < max && node->previous != NULL)
 	{
-		if (expression(*result, iterator->info) == GREATER) *result = iterator->info;
-		MOVE_NEXT;
+		node = node->previous;
+		buffer[total++] = node->info;
 	}
+	iterator->pointer = node;
+	iterator->position -= total;
+	return total;
+}
+
+// Marks the list_t as edited, keeping the given iterator in sync
+#define SYNC_ITERATOR                          \
+iterator->list->sync++;                        \
+iterator->sync = iterator->list->sync
+
+// Inserts the first item of a list_t emptied by iterator_remove
+static inline bool_t iteratorInsertFirst(list_iterator_t iterator, const T item)
+{
+	iterator->pointer = linkBefore(iterator->list, NULL, item);
+	iterator->position = 0;
+	iterator->started = FALSE;
+	SYNC_ITERATOR;
 	return TRUE;
 }
 
-// GetNumericMax
-int get_numeric_max(list_t list, int(*expression)(T))
+// IteratorInsertBefore
+bool_t iterator_insert_before(list_iterator_t iterator, const T item)
 {
-	RETURN_IF_EMPTY(list, (T)NULL);
-	GET_HEAD_ITERATOR;
-	int maximum = INT_MIN;
-	while (iterator != NULL)
-	{
-		int temp = expression(iterator->info);
-		if (temp > maximum) maximum = temp;
-		MOVE_NEXT;
-	}
-	return maximum;
+	if (iterator == NULL) return FALSE;
+	RETURN_IF_OUT_OF_SYNC(FALSE);
+	if (iterator->pointer == NULL) return iteratorInsertFirst(iterator, item);
+	linkBefore(iterator->list, iterator->pointer, item);
+	iterator->position++;
+	SYNC_ITERATOR;
+	return TRUE;
 }
 
-// GetMax
-bool_t get_max(list_t list, T* result, comparation(*expression)(T, T))
+// IteratorInsertAfter
+bool_t iterator_insert_after(list_iterator_t iterator, const T item)
 {
-	RETURN_IF_EMPTY(list, FALSE);
-	FIRST_IF_SINGLE_ITEM;
-	GET_HEAD_ITERATOR;
-	*result = iterator->info;
-	MOVE_NEXT;
-	while (iterator != NULL)
+	if (iterator == NULL) return FALSE;
+	RETURN_IF_OUT_OF_SYNC(FALSE);
+	if (iterator->pointer == NULL) return iteratorInsertFirst(iterator, item);
+	linkBefore(iterator->list, iterator->pointer->next, item);
+	SYNC_ITERATOR;
+	return TRUE;
+}
+
+// IteratorRemove
+bool_t iterator_remove(list_iterator_t iterator)
+{
+	if (iterator == NULL) return FALSE;
+	RETURN_IF_OUT_OF_SYNC(FALSE);
+	RETURN_IF_NO_CURRENT(FALSE);
+	nodePointer target = iterator->pointer;
+	if (target->previous != NULL)
 	{
-		if (expression(*result, iterator->info) == LOWER) *result = iterator->info;
-		MOVE_NEXT;
+		// Step back, so that the next function returns the following item
+		iterator->pointer = target->previous;
+		iterator->position--;
+	}
+	else
+	{
+		// First node: the following one will become the first item to return
+		iterator->pointer = target->next;
+		iterator->started = FALSE;
 	}
+	unlinkNode(iterator->list, target);
+	SYNC_ITERATOR;
 	return TRUE;
 }
 
-// OrderHelper
-static inline list_t orderHelper(list_t list, comparation(*expression)(T, T), bool_t reverse)
+// ForEachRemaining
+int for_each_remaining(list_iterator_t iterator, void(*expression)(T))
 {
-	list_t outList = copy(list);
-	if (list->length == 1) return outList;
-	bool_t sorted = FALSE;
-	GET_ITERATOR(outList->head);
+	if (iterator == NULL) return -1;
+	RETURN_IF_OUT_OF_SYNC(-1);
+	RETURN_IF_NO_CURRENT(0);
+	iterator->started = TRUE;
+	int start = iterator->position;
 	while (TRUE)
 	{
-		comparation result = expression(iterator->info, iterator->next->info);
-		if (reverse && result != EQUAL)
-		{
-			result = result == GREATER ? LOWER : GREATER;
-		}
-		if (result == GREATER)
-		{
-			T backup = iterator->info;
-			iterator->info = iterator->next->info;
-			iterator->next->info = backup;
-			sorted = TRUE;
-		}
-		bool_t loopEnd = iterator->next->next == NULL ? TRUE : FALSE;
-		if (loopEnd && sorted)
-		{
-			iterator = outList->head;
-			sorted = FALSE;
-		}
-		else if (loopEnd) break;
-		else MOVE_NEXT;
+		expression(iterator->pointer->info);
+		if (iterator->pointer->next == NULL) break;
+		iterator->pointer = iterator->pointer->next;
+		iterator->position++;
 	}
-	return outList;
+	return iterator->position - start;
 }
 
-// InPlaceOrderBy
-list_t in_place_order_by(list_t list, comparation(*expression)(T, T))
+// Restart
+bool_t restart(list_iterator_t iterator)
 {
-	NULL_IF_EMPTY(list);
-	return orderHelper(list, expression, FALSE);
+	if (iterator == NULL) return FALSE;
+	iterator->position = 0;
+	iterator->pointer = iterator->list->head;
+	iterator->sync = iterator->list->sync;
+	iterator->started = FALSE;
+	return TRUE;
 }
 
-// InPlaceOrderByDescending
-list_t in_place_order_by_descending(list_t list, comparation(*expression)(T, T))
+// Number of items in each block when the caller doesn't provide a buffer
+#define DEFAULT_SPAN_CAPACITY 256
+
+// GetSpanIterator
+list_span_iterator_t get_span_iterator(list_t list, T* buffer, int capacity)
 {
-	NULL_IF_EMPTY(list);
-	return orderHelper(list, expression, TRUE);
+	if (list == NULL || (buffer != NULL && capacity <= 0)) return NULL;
+	if (capacity <= 0) capacity = DEFAULT_SPAN_CAPACITY;
+	list_span_iterator_t iterator = (list_span_iterator_t)malloc(sizeof(struct listSpanIterator));
+	iterator->list = list;
+	iterator->pointer = list->head;
+	iterator->sync = list->sync;
+	iterator->capacity = capacity;
+	iterator->ownsBuffer = buffer == NULL;
+	iterator->buffer = buffer != NULL ? buffer : (T*)malloc(sizeof(T) * capacity);
+	return iterator;
 }
 
-// OrderBy
-list_t order_by(list_t list, comparation(*expression)(T, T))
+// NextSpan
+bool_t next_span(list_span_iterator_t iterator, const T** data, int* len)
 {
-	NULL_IF_EMPTY(list);
-	int len;
-	T* temp_vector = to_array(list, &len);
-	introsort(temp_vector, len, expression);
-	list = create_from(temp_vector, len);
-	free(temp_vector);
-	return list;
+	if (iterator == NULL) return FALSE;
+	RETURN_IF_OUT_OF_SYNC(FALSE);
+	int n = fillBatch(&iterator->pointer, iterator->buffer, iterator->capacity);
+	if (n == 0) return FALSE;
+	*data = iterator->buffer;
+	*len = n;
+	return TRUE;
 }
 
-// OrderByDescending
-list_t order_by_descending(list_t list, comparation(*expression)(T, T))
+// DestroySpanIterator
+bool_t destroy_span_iterator(list_span_iterator_t* iterator)
 {
-	// Get the sorted array
-	NULL_IF_EMPTY(list);
-	int len;
-	T* temp_vector = to_array(list, &len);
-	introsort(temp_vector, len, expression);
-
-	// Reverse the array and return a new list
-	int i, target = len >> 1;
-	for (i = 0; i < target; i++)
-	{
-		T temp = temp_vector[i];
-		temp_vector[i] = temp_vector[target];
-		temp_vector[target] = temp;
-		target--;
-	}
-	list = create_from(temp_vector, len);
-	free(temp_vector);
-	return list;
+	if (*iterator == NULL) return FALSE;
+	if ((*iterator)->ownsBuffer) free((*iterator)->buffer);
+	free(*iterator);
+	*iterator = NULL;
+	return TRUE;
 }
 
-/* ============== Other LINQ functions ============== */
-
-#define GET_DISTINCT_LIST                                       \
-list_t outList = create();                                    \
-GET_HEAD_ITERATOR;                                              \
-while (iterator != NULL)                                        \
-{                                                               \
-	nodePointer testIterator = outList->head;                 \
-	bool_t found = FALSE;                                       \
-	while (testIterator != NULL)                                \
-	{                                                           \
-		if (expression(iterator->info, testIterator->info))     \
-		{                                                       \
-			found = TRUE;                                       \
-			break;                                              \
-		}                                                       \
-		testIterator = testIterator->next;                      \
-	}                                                           \
-	if (!found) add(iterator->info, outList);                 \
-	MOVE_NEXT;                                                  \
-}
+/* ============================================================================
+*  Hash index
+*  ========================================================================= */
 
-// Distinct
-list_t distinct(list_t list, bool_t(*expression)(T, T))
+// EnableHashIndex
+bool_t enable_hash_index(list_t list, unsigned int(*hash)(T))
 {
-	NULL_IF_EMPTY(list);
-	GET_DISTINCT_LIST;
-	return outList;
+	if (list == NULL || hash == NULL) return FALSE;
+	if (list->index != NULL) hashIndexFree(list->index);
+	struct hashIndex* index = (struct hashIndex*)malloc(sizeof(struct hashIndex));
+	unsigned int buckets = INITIAL_BUCKETS;
+	while (buckets < (unsigned int)list->length) buckets <<= 1;
+	index->hash = hash;
+	index->buckets = (struct hashEntry**)calloc(buckets, sizeof(struct hashEntry*));
+	index->mask = buckets - 1;
+	index->count = 0;
+	index->recycled = NULL;
+	list->index = index;
+	GET_HEAD_ITERATOR;
+	while (iterator != NULL)
+	{
+		hashIndexInsert(index, iterator);
+		MOVE_NEXT;
+	}
+	return TRUE;
 }
 
-// CountDistinct
-int count_distinct(list_t list, bool_t(*expression)(T, T))
+// DisableHashIndex
+bool_t disable_hash_index(list_t list)
 {
-	if (list == NULL) return -1;
-	if (list->length == 0) return 0;
-	GET_DISTINCT_LIST;
-	return outList->length;
+	if (list == NULL || list->index == NULL) return FALSE;
+	hashIndexFree(list->index);
+	list->index = NULL;
+	return TRUE;
 }
 
-// Single
-bool_t single(list_t list, T* result, bool_t(*expression)(T))
+/* ============================================================================
+*  Bloom filter
+*  ========================================================================= */
+
+// EnableBloomFilter
+bool_t enable_bloom_filter(list_t list, unsigned int(*hash)(T), int capacity, float rate)
 {
-	RETURN_IF_EMPTY(list, FALSE);
-	bool_t found = FALSE;
-	GET_HEAD_ITERATOR;
-	while (iterator != NULL)
+	if (list == NULL || hash == NULL || rate <= 0 || rate >= 1) return FALSE;
+	if (capacity <= 0) capacity = DEFAULT_BLOOM_CAPACITY;
+	if (capacity < list->length) capacity = list->length;
+	struct bloomFilter* filter = (struct bloomFilter*)malloc(sizeof(struct bloomFilter));
+	if (filter == NULL) return FALSE;
+	filter->hash = hash;
+	filter->rate = rate;
+	filter->bits = NULL;
+	if (!bloomFilterSize(filter, capacity))
 	{
-		if (expression(iterator->info))
-		{
-			if (found) return FALSE;
-			found = TRUE;
-			*result = iterator->info;
-		}
-		MOVE_NEXT;
+		free(filter);
+		return FALSE;
 	}
-	return found;
+	if (list->filter != NULL) bloomFilterFree(list->filter);
+	list->filter = filter;
+	bloomFilterBuild(list, capacity);
+	return TRUE;
+}
+
+// RebuildBloomFilter
+bool_t rebuild_bloom_filter(list_t list)
+{
+	if (list == NULL || list->filter == NULL) return FALSE;
+	bloomFilterBuild(list, list->filter->capacity);
+	return TRUE;
 }
 
-// RemoveWhere
-list_t remove_where(list_t list, bool_t(*expression)(T))
+// DisableBloomFilter
+bool_t disable_bloom_filter(list_t list)
 {
-	NULL_IF_EMPTY(list);
-	list_t outList = create();
-	GET_HEAD_ITERATOR;
-	while (iterator != NULL)
-	{
-		if (!expression(iterator->info)) add(iterator->info, outList);
-		MOVE_NEXT;
-	}
-	return outList;
+	if (list == NULL || list->filter == NULL) return FALSE;
+	bloomFilterFree(list->filter);
+	list->filter = NULL;
+	return TRUE;
 }
 
-// ReplaceWhere
-list_t replace_where(list_t list, const T replacement, bool_t(*expression)(T))
+/* ============================================================================
+*  Incremental aggregates
+*  ========================================================================= */
+
+// RegisterAggregate
+list_aggregate_t register_aggregate(list_t list, int(*expression)(T))
 {
-	NULL_IF_EMPTY(list);
-	list_t outList = create();
+	if (list == NULL || expression == NULL) return NULL;
+	list_aggregate_t aggregate = (list_aggregate_t)calloc(1, sizeof(struct listAggregate));
+	aggregate->expression = expression;
+	aggregate->max.max = TRUE;
 	GET_HEAD_ITERATOR;
 	while (iterator != NULL)
 	{
-		if (expression(iterator->info)) add(replacement, outList);
-		else add(iterator->info, outList);
+		aggregateInsert(aggregate, iterator->info);
 		MOVE_NEXT;
 	}
-	return outList;
+	aggregate->next = list->aggregates;
+	list->aggregates = aggregate;
+	return aggregate;
 }
 
-// Derive
-list_t derive(list_t list, T(*expression)(T))
+// UnregisterAggregate
+bool_t unregister_aggregate(list_t list, list_aggregate_t* aggregate)
 {
-	NULL_IF_EMPTY(list);
-	list_t outList = create();
-	GET_HEAD_ITERATOR;
-	while (iterator != NULL)
+	if (list == NULL || *aggregate == NULL) return FALSE;
+	list_aggregate_t* link = &list->aggregates;
+	while (*link != NULL)
 	{
-		add(expression(iterator->info), outList);
-		MOVE_NEXT;
+		if (*link == *aggregate)
+		{
+			*link = (*aggregate)->next;
+			aggregateFree(*aggregate);
+			*aggregate = NULL;
+			return TRUE;
+		}
+		link = &(*link)->next;
 	}
-	return outList;
+	return FALSE;
 }
 
-// SequenceEquals
-bool_t sequence_equals(list_t list1, list_t list2, bool_t(*expression)(T, T))
+// AggregateCount
+int aggregate_count(list_aggregate_t aggregate)
 {
-	if (list1 == NULL || list2 == NULL)
-	{
-		return list1 == NULL && list2 == NULL;
-	}
-	if (list1->length != list2->length) return FALSE;
-	GET_COUPLE_ITERATORS;
-	while (iterator1 != NULL)
-	{
-		if (!expression(iterator1->info, iterator2->info)) return FALSE;
-		iterator1 = iterator1->next;
-		iterator2 = iterator2->next;
-	}
-	return TRUE;
+	return aggregate == NULL ? -1 : aggregate->count;
 }
 
-// Trim
-list_t trim(list_t list, int length)
+#define ZERO_IF_NO_VALUES if (aggregate == NULL || aggregate->count == 0) return 0
+
+// AggregateSum
+int aggregate_sum(list_aggregate_t aggregate)
 {
-	NULL_IF_EMPTY(list);
-	if (list->length <= length) return copy(list);
-	list_t outList = create();
-	GET_HEAD_ITERATOR;
-	int position = 0;
-	while (position < length)
-	{
-		add(iterator->info, outList);
-		MOVE_NEXT_W_INDEX(position);
-	}
-	return outList;
+	ZERO_IF_NO_VALUES;
+	return (int)aggregate->sum;
+}
+
+// AggregateAverage
+int aggregate_average(list_aggregate_t aggregate)
+{
+	ZERO_IF_NO_VALUES;
+	return (int)(aggregate->sum / aggregate->count);
+}
+
+// AggregateMin
+int aggregate_min(list_aggregate_t aggregate)
+{
+	ZERO_IF_NO_VALUES;
+	return aggregate->min.items[0];
+}
+
+// AggregateMax
+int aggregate_max(list_aggregate_t aggregate)
+{
+	ZERO_IF_NO_VALUES;
+	return aggregate->max.items[0];
 }
 
 /* ============================================================================
-*  Iterator
+*  Range queries
 *  ========================================================================= */
 
-// GetIterator
-list_iterator_t get_iterator(list_t list)
+// EnableRangeQueries
+bool_t enable_range_queries(list_t list, int(*expression)(T))
 {
-	NULL_IF_EMPTY(list);
-	list_iterator_t iterator = (list_iterator_t)malloc(sizeof(iteratorInstance));
-	iterator->list = list;
-	iterator->pointer = list->head;
-	iterator->position = 0;
-	iterator->sync = list->sync;
-	iterator->started = FALSE;
-	return iterator;
+	if (list == NULL || expression == NULL) return FALSE;
+	if (list->ranges != NULL) rangeTreeFree(list->ranges);
+	list->ranges = (struct rangeTree*)calloc(1, sizeof(struct rangeTree));
+	list->ranges->expression = expression;
+	return TRUE;
 }
 
-// DestroyIterator
-bool_t destroy_iterator(list_iterator_t* iterator)
+// DisableRangeQueries
+bool_t disable_range_queries(list_t list)
 {
-	if (*iterator == NULL) return FALSE;
-	free(*iterator);
-	*iterator = NULL;
+	if (list == NULL || list->ranges == NULL) return FALSE;
+	rangeTreeFree(list->ranges);
+	list->ranges = NULL;
 	return TRUE;
 }
 
-// IsSynced
-bool_t is_synced(list_iterator_t iterator)
+// Checks the arguments of a range query and rebuilds the tree if needed
+#define RANGE_QUERY_BEGIN                                                     \
+if (list == NULL || list->ranges == NULL || result == NULL || start < 0    \
+	|| end < start || end >= list->length) return FALSE;                  \
+struct rangeTree* tree = list->ranges;                                    \
+if (!tree->valid) rangeTreeBuild(list);                                   \
+int left = start + tree->size, right = end + tree->size + 1
+
+// Visits the nodes that cover the range, from the leaves to the root
+#define RANGE_QUERY_LOOP(visit)                  \
+for (; left < right; left >>= 1, right >>= 1)   \
+{                                               \
+	if (left & 1) { visit(left); left++; }      \
+	if (right & 1) { right--; visit(right); }   \
+}
+
+#define VISIT_SUM(i) total += tree->sums[i]
+#define VISIT_MIN(i) if (tree->mins[i] < minimum) minimum = tree->mins[i]
+#define VISIT_MAX(i) if (tree->maxs[i] > maximum) maximum = tree->maxs[i]
+
+// RangeSum
+bool_t range_sum(list_t list, int start, int end, int* result)
 {
-	if (iterator == NULL) return FALSE;
-	return iterator->sync == iterator->list->sync ? TRUE : FALSE;
+	RANGE_QUERY_BEGIN;
+	long long total = 0;
+	RANGE_QUERY_LOOP(VISIT_SUM);
+	*result = (int)total;
+	return TRUE;
 }
 
-#define RETURN_IF_OUT_OF_SYNC(value)                        \
-if (iterator->sync != iterator->list->sync) return value;
+// RangeMin
+bool_t range_min(list_t list, int start, int end, int* result)
+{
+	RANGE_QUERY_BEGIN;
+	int minimum = INT_MAX;
+	RANGE_QUERY_LOOP(VISIT_MIN);
+	*result = minimum;
+	return TRUE;
+}
 
-// GetCurrent
-bool_t get_current(list_iterator_t iterator, T* result)
+// RangeMax
+bool_t range_max(list_t list, int start, int end, int* result)
 {
-	if (iterator == NULL) return FALSE;
-	RETURN_IF_OUT_OF_SYNC(FALSE);
-	*result = iterator->pointer->info;
+	RANGE_QUERY_BEGIN;
+	int maximum = INT_MIN;
+	RANGE_QUERY_LOOP(VISIT_MAX);
+	*result = maximum;
 	return TRUE;
 }
 
-// Next
-bool_t next(list_iterator_t iterator, T* result)
+/* ============================================================================
+*  Views
+*  ========================================================================= */
+
+#define VIEW_BUCKET(view, node) \
+(view->buckets + ((unsigned int)(((size_t)node >> 4) * 2654435761u) & view->mask))
+
+// Returns the node of the view that corresponds to the given source node, or NULL
+static nodePointer viewLookup(list_view_t view, nodePointer node)
 {
-	if (iterator == NULL) return FALSE;
-	RETURN_IF_OUT_OF_SYNC(FALSE);
-	if (iterator->started == FALSE)
+	struct viewEntry* entry = *VIEW_BUCKET(view, node);
+	while (entry != NULL)
 	{
-		iterator->started = TRUE;
-		*result = iterator->pointer->info;
-		return TRUE;
+		if (entry->source == node) return entry->target;
+		entry = entry->next;
 	}
-	if (move_next(iterator) == FALSE) return FALSE;
-	*result = iterator->pointer->info;
-	return TRUE;
+	return NULL;
 }
 
-// CheckGoForward
-static inline bool_t checkGoForward(list_iterator_t iterator)
+// Doubles the number of buckets of the map and moves the entries inside the new ones
+static void viewGrow(list_view_t view)
 {
-	if (iterator == NULL) return FALSE;
-	RETURN_IF_OUT_OF_SYNC(FALSE);
-	return iterator->pointer->next != NULL ? TRUE : FALSE;
+	unsigned int oldSize = view->mask + 1, i;
+	struct viewEntry** oldBuckets = view->buckets;
+	view->mask = (oldSize << 1) - 1;
+	view->buckets = (struct viewEntry**)calloc(oldSize << 1, sizeof(struct viewEntry*));
+	for (i = 0; i < oldSize; i++)
+	{
+		struct viewEntry* entry = oldBuckets[i];
+		while (entry != NULL)
+		{
+			struct viewEntry* next = entry->next;
+			struct viewEntry** bucket = VIEW_BUCKET(view, entry->source);
+			entry->next = *bucket;
+			*bucket = entry;
+			entry = next;
+		}
+	}
+	free(oldBuckets);
 }
 
-// CanGoForward
-bool_t can_go_forward(list_iterator_t iterator)
+// Adds a source node to the map, along with its node inside the view
+static void viewMapAdd(list_view_t view, nodePointer source, nodePointer target)
 {
-	return checkGoForward(iterator);
+	if ((unsigned int)view->count > view->mask) viewGrow(view);
+	struct viewEntry* entry = view->recycled;
+	if (entry != NULL) view->recycled = entry->next;
+	else entry = (struct viewEntry*)malloc(sizeof(struct viewEntry));
+	struct viewEntry** bucket = VIEW_BUCKET(view, source);
+	entry->source = source;
+	entry->target = target;
+	entry->next = *bucket;
+	*bucket = entry;
+	view->count++;
 }
 
-// CheckGoBack
-static inline bool_t checkGoBack(list_iterator_t iterator)
+// Removes a source node from the map and returns its node inside the view, or NULL
+static nodePointer viewMapRemove(list_view_t view, nodePointer source)
 {
-	if (iterator == NULL) return FALSE;
-	RETURN_IF_OUT_OF_SYNC(FALSE);
-	return iterator->pointer->previous != NULL ? TRUE : FALSE;
+	struct viewEntry** link = VIEW_BUCKET(view, source);
+	while (*link != NULL)
+	{
+		struct viewEntry* entry = *link;
+		if (entry->source == source)
+		{
+			*link = entry->next;
+			entry->next = view->recycled;
+			view->recycled = entry;
+			view->count--;
+			return entry->target;
+		}
+		link = &entry->next;
+	}
+	return NULL;
 }
 
-// CanGoBack
-bool_t can_go_back(list_iterator_t iterator)
+// Removes all the entries from the map
+static void viewMapReset(list_view_t view)
 {
-	return checkGoBack(iterator);
+	unsigned int i;
+	for (i = 0; i <= view->mask; i++)
+	{
+		struct viewEntry* entry = view->buckets[i];
+		while (entry != NULL)
+		{
+			struct viewEntry* next = entry->next;
+			entry->next = view->recycled;
+			view->recycled = entry;
+			entry = next;
+		}
+		view->buckets[i] = NULL;
+	}
+	view->count = 0;
 }
 
-// MoveNext
-bool_t move_next(list_iterator_t iterator)
+#define VIEW_ACCEPTS(view, item) (view->condition == NULL || view->condition(item))
+#define VIEW_DERIVE(view, item) (view->transform == NULL ? item : view->transform(item))
+
+// Adds the derived item of a source node to the view, if it satisfies the predicate.
+// The position is found walking the source list_t in both directions at the same
+// time, up to the closest node that is inside the view or to one of its ends,
+// so that the cost is O(1) when the node is added at the start or at the end.
+static void viewInsert(list_view_t view, nodePointer node)
 {
-	if (!checkGoForward(iterator)) return FALSE;
-	iterator->pointer = iterator->pointer->next;
-	iterator->position++;
-	iterator->started = TRUE;
-	return TRUE;
+	if (!VIEW_ACCEPTS(view, node->info)) return;
+	nodePointer back = node->previous, forward = node->next, target, position = NULL;
+	while (TRUE)
+	{
+		if (forward == NULL) break;
+		if ((target = viewLookup(view, forward)) != NULL)
+		{
+			position = target;
+			break;
+		}
+		if (back == NULL)
+		{
+			position = view->output->head;
+			break;
+		}
+		if ((target = viewLookup(view, back)) != NULL)
+		{
+			position = target->next;
+			break;
+		}
+		forward = forward->next;
+		back = back->previous;
+	}
+	viewMapAdd(view, node, linkBefore(view->output, position, VIEW_DERIVE(view, node->info)));
+	view->output->sync++;
 }
 
-// MoveBack
-bool_t move_back(list_iterator_t iterator)
+// Removes the derived item of a source node from the view
+static void viewRemove(list_view_t view, nodePointer node)
 {
-	if (!checkGoBack(iterator)) return FALSE;
-	iterator->pointer = iterator->pointer->previous;
-	iterator->position--;
-	return TRUE;
+	nodePointer target = viewMapRemove(view, node);
+	if (target == NULL) return;
+	unlinkNode(view->output, target);
+	view->output->sync++;
 }
 
-// ActualPosition
-int actual_position(list_iterator_t iterator)
+// Updates the view after the item of a source node has been replaced
+static void viewReplace(list_view_t view, nodePointer node)
 {
-	if (iterator == NULL) return -1;
-	RETURN_IF_OUT_OF_SYNC(-1);
-	return iterator->position;
+	nodePointer target = viewLookup(view, node);
+	if (target == NULL) viewInsert(view, node);
+	else if (!VIEW_ACCEPTS(view, node->info)) viewRemove(view, node);
+	else
+	{
+		replaceNode(view->output, target, VIEW_DERIVE(view, node->info));
+		view->output->sync++;
+	}
 }
 
-// ElementsLeft
-int elements_left(list_iterator_t iterator)
+// Updates the map of the view after a source node has been moved to a new address
+static void viewMove(list_view_t view, nodePointer old, nodePointer node)
 {
-	if (iterator == NULL) return -1;
-	RETURN_IF_OUT_OF_SYNC(-1);
-	return iterator->list->length - iterator->position;
+	nodePointer target = viewMapRemove(view, old);
+	if (target != NULL) viewMapAdd(view, node, target);
 }
 
-// ForEachRemaining
-int for_each_remaining(list_iterator_t iterator, void(*expression)(T))
+// Removes all the items from the view
+static void viewReset(list_view_t view)
 {
-	if (iterator == NULL) return -1;
-	RETURN_IF_OUT_OF_SYNC(-1);
-	iterator->started = TRUE;
-	int start = iterator->position;
-	while (TRUE)
+	clear(view->output);
+	viewMapReset(view);
+}
+
+// Builds the view again with all the items of the source list_t
+static void viewRebuild(list_view_t view)
+{
+	viewReset(view);
+	nodePointer iterator = view->source->head;
+	while (iterator != NULL)
 	{
-		expression(iterator->pointer->info);
-		if (iterator->pointer->next == NULL) break;
-		iterator->pointer = iterator->pointer->next;
-		iterator->position++;
+		if (VIEW_ACCEPTS(view, iterator->info))
+		{
+			viewMapAdd(view, iterator, linkBefore(view->output, NULL, VIEW_DERIVE(view, iterator->info)));
+		}
+		MOVE_NEXT;
 	}
-	return iterator->position - start;
+	view->output->sync++;
 }
 
-// Restart
-bool_t restart(list_iterator_t iterator)
+// CreateView
+list_view_t create_view(list_t source, bool_t(*predicate)(T), T(*deriver)(T))
 {
-	if (iterator == NULL) return FALSE;
-	iterator->position = 0;
-	iterator->pointer = iterator->list->head;
-	iterator->sync = iterator->list->sync;
-	iterator->started = FALSE;
+	if (source == NULL) return NULL;
+	list_view_t view = (list_view_t)malloc(sizeof(struct listView));
+	view->source = source;
+	view->output = create();
+	view->condition = predicate;
+	view->transform = deriver;
+	view->buckets = (struct viewEntry**)calloc(INITIAL_BUCKETS, sizeof(struct viewEntry*));
+	view->mask = INITIAL_BUCKETS - 1;
+	view->count = 0;
+	view->recycled = NULL;
+	viewRebuild(view);
+	view->next = source->views;
+	source->views = view;
+	return view;
+}
+
+// ViewList
+list_t view_list(list_view_t view)
+{
+	return view == NULL ? NULL : view->output;
+}
+
+// RefreshView
+bool_t refresh_view(list_view_t view)
+{
+	if (view == NULL || view->source == NULL) return FALSE;
+	viewRebuild(view);
+	return TRUE;
+}
+
+// DestroyView
+bool_t destroy_view(list_view_t* view)
+{
+	if (*view == NULL) return FALSE;
+	if ((*view)->source != NULL)
+	{
+		list_view_t* link = &(*view)->source->views;
+		while (*link != *view) link = &(*link)->next;
+		*link = (*view)->next;
+	}
+	viewMapReset(*view);
+	while ((*view)->recycled != NULL)
+	{
+		struct viewEntry* next = (*view)->recycled->next;
+		free((*view)->recycled);
+		(*view)->recycled = next;
+	}
+	free((*view)->buckets);
+	destroy(&(*view)->output);
+	free(*view);
+	*view = NULL;
+	return TRUE;
+}
+
+/* ============================================================================
+*  Observers
+*  ========================================================================= */
+
+#ifdef LIST_T_OBSERVERS
+
+// AddObserver
+bool_t add_observer(list_t list, list_observer_t observer, void* ctx)
+{
+	if (list == NULL || observer == NULL) return FALSE;
+	struct listObserver* item = (struct listObserver*)malloc(sizeof(struct listObserver));
+	item->observer = observer;
+	item->ctx = ctx;
+	item->next = list->observers;
+
+	// The cached node is not updated while there are no observers, so it may have been freed
+	if (list->observers == NULL) list->observedNode = NULL;
+	list->observers = item;
 	return TRUE;
-}
\ No newline at end of file
+}
+
+// RemoveObserver
+bool_t remove_observer(list_t list, list_observer_t observer, void* ctx)
+{
+	if (list == NULL) return FALSE;
+	struct listObserver** link = &list->observers;
+	while (*link != NULL)
+	{
+		struct listObserver* item = *link;
+		if (item->observer == observer && item->ctx == ctx)
+		{
+			*link = item->next;
+			free(item);
+			return TRUE;
+		}
+		link = &item->next;
+	}
+	return FALSE;
+}
+
+#endif
@@ -9,6 +9,8 @@
 #ifndef LIST_T_H
 #define LIST_T_H
 
+#include <stdio.h>
+
 /* =================== Define your custom Type here ====================
 *  NOTE:
 *    You can use a standard value type, a pointer type or a custom
@@ -22,6 +24,9 @@
 typedef TYPE T;
 typedef enum { FALSE, TRUE } bool_t;
 typedef struct listIterator* list_iterator_t;
+typedef struct listSpanIterator* list_span_iterator_t;
+typedef struct listAggregate* list_aggregate_t;
+typedef struct listView* list_view_t;
 typedef struct listBase* list_t;
 typedef list_t stack_t;
 
@@ -95,6 +100,7 @@ void destroy_sequence(bool_t* result, list_t** pending);
 *  ---------------------------------------------------------------------
 *  Description:
 *    Copies the source list_t and returns a new one with the same items.
+*    All the nodes of the new list_t are allocated at once.
 *  Parameters:
 *    source ---> The input list_t */
 list_t copy(const list_t source);
@@ -120,12 +126,37 @@ list_t create_random(int length, int min, int max);
 *  CreateFrom
 *  ---------------------------------------------------------------------
 *  Description:
-*    Creates a new list_t from an array of T elements.
+*    Creates a new list_t from an array of T elements. Just like the
+*    add_range function, all the nodes are allocated at once.
+*  NOTE:
+*    See add_range: the block is kept until all its nodes are removed.
 *  Parameters:
 *    array ---> The input array
 *    size ---> The length of the source array */
 list_t create_from(T* array, int size);
 
+/* ---------------------------------------------------------------------
+*  AddRange
+*  ---------------------------------------------------------------------
+*  Description:
+*    Adds all the items of an array at the end of the list_t. All the
+*    new nodes are allocated with a single call and are adjacent in
+*    memory, so that iterating over them is faster. The memory block
+*    is deallocated when all its nodes have been removed.
+*    Returns FALSE if the list_t or the array is NULL, or if the size
+*    is not greater than 0.
+*  NOTE:
+*    A single node that is still in use keeps its whole block allocated,
+*    even if the other nodes have been removed or moved to another
+*    list_t with a splice. After removing most of the items added with
+*    a large add_range, call list_compact to copy the remaining ones to
+*    a new block and release the old one.
+*  Parameters:
+*    list ---> The list_t to edit
+*    array ---> The input array
+*    size ---> The length of the source array */
+bool_t add_range(list_t list, const T* array, int size);
+
 /* ---------------------------------------------------------------------
 *  ToArray
 *  ---------------------------------------------------------------------
@@ -250,6 +281,88 @@ bool_t add_at(const T item, list_t list, int index);
 *    source ---> The source list_t */
 bool_t add_all(list_t target, const list_t source);
 
+/* ---------------------------------------------------------------------
+*  ListSpliceBack
+*  ---------------------------------------------------------------------
+*  Description:
+*    Moves all the items of the source list_t at the end of the target
+*    list_t in O(1), relinking the nodes instead of copying them. The
+*    source list_t is left empty, but it is NOT deallocated.
+*    Returns FALSE if either one of the two list_ts is NULL or if they
+*    are the same list_t.
+*  Parameters:
+*    target ---> The target list_t
+*    source ---> The list_t whose items will be moved */
+bool_t list_splice_back(list_t target, list_t source);
+
+/* ---------------------------------------------------------------------
+*  ListSpliceRange
+*  ---------------------------------------------------------------------
+*  Description:
+*    Moves the items of the source list_t between the two given indexes,
+*    including them, inside the target list_t at the given index. The
+*    nodes are relinked instead of being copied, and both the list_ts
+*    are updated. Returns FALSE if either one of the two list_ts is NULL,
+*    if they are the same list_t or if the indexes are not valid.
+*  Parameters:
+*    target ---> The target list_t
+*    index ---> The position of the first moved item inside the target
+*               list_t, use its length to add the items at the end
+*    source ---> The list_t whose items will be moved
+*    start ---> The index of the first item to move
+*    end ---> The index of the last item to move */
+bool_t list_splice_range(list_t target, int index, list_t source, int start, int end);
+
+/* ---------------------------------------------------------------------
+*  ListCompact
+*  ---------------------------------------------------------------------
+*  Description:
+*    Moves all the items of the list_t inside a single block of memory,
+*    allocating the new nodes in traversal order. The content of the
+*    list_t doesn't change, but its Iterators become invalid.
+*    After many insertions and removals the nodes of a list_t can end
+*    up scattered across the heap: compacting it makes iterating over
+*    its items faster. See the list_locality function below.
+*    Returns FALSE if the list_t is NULL or empty.
+*  Parameters:
+*    list ---> The list_t to compact */
+bool_t list_compact(list_t list);
+
+/* ---------------------------------------------------------------------
+*  ListCompactStep
+*  ---------------------------------------------------------------------
+*  Description:
+*    Incremental version of the list_compact function: each call moves
+*    up to count items inside a new block of memory, continuing from
+*    where the previous call stopped, even if the list_t has been edited
+*    in the meantime (the items added before that point are not moved).
+*    Returns 0 when the compaction has reached the end of the list_t,
+*    the number of items still to compact otherwise (an estimate, if the
+*    list_t has been edited during the compaction), or -1 if the list_t
+*    is NULL or count is not greater than 0. Once the compaction has
+*    finished, the following calls return 0 without moving any item
+*    until the list_t is edited: then a new compaction starts from the
+*    first item.
+*  Example:
+*    while (list_compact_step(list, 1024) > 0) do_other_work();
+*  Parameters:
+*    list ---> The list_t to compact
+*    count ---> The maximum number of items to move */
+int list_compact_step(list_t list, int count);
+
+/* ---------------------------------------------------------------------
+*  ListLocality
+*  ---------------------------------------------------------------------
+*  Description:
+*    Returns the fraction of the items inside the list_t whose next
+*    node follows them in memory within a short distance, from 0 to 1.
+*    A freshly built or compacted list_t has a value close to 1, while
+*    lower values mean that a call to list_compact will make iterating
+*    over the list_t faster. Returns -1 if the list_t is NULL or empty.
+*  Parameters:
+*    list ---> The input list_t */
+float list_locality(list_t list);
+
 /* ---------------------------------------------------------------------
 *  Size
 *  ---------------------------------------------------------------------
@@ -373,6 +486,91 @@ bool_t formatted_print(char* pattern, list_t list);
 *    list ---> The input list */
 bool_t print(char* pattern, list_t list);
 
+/* ---------------------------------------------------------------------
+*  ListWrite
+*  ---------------------------------------------------------------------
+*  Description:
+*    Writes all the items inside the list_t to the given stream, using
+*    the same pattern for each item and the separator between each pair
+*    of items. The text is collected inside a large buffer and written
+*    with a single call for each block, and if T is int and the pattern
+*    is "%d" the items are converted without calling printf at all.
+*    Returns FALSE if a parameter is NULL or if the stream can't be
+*    written, TRUE otherwise (even if the list_t is empty).
+*  Example:
+*    list_write(stderr, list, "%d", "\n");
+*  NOTE:
+*    A file descriptor can be used by opening a stream with fdopen.
+*  Parameters:
+*    stream ---> The target stream
+*    list ---> The input list_t
+*    pattern ---> The pattern to use to print each item
+*    separator ---> The text to write between two items, or NULL */
+bool_t list_write(FILE* stream, list_t list, char* pattern, char* separator);
+
+/* ---------------------------------------------------------------------
+*  ListSprint
+*  ---------------------------------------------------------------------
+*  Description:
+*    Same as list_write, but it writes the text inside the buffer, just
+*    like snprintf: at most capacity - 1 characters are written, followed
+*    by the string terminator. Returns the length of the whole text (so
+*    that a result >= capacity means that the text has been truncated),
+*    or -1 if the list_t or the pattern are NULL or if the capacity is
+*    not valid. The buffer can be NULL if the capacity is 0.
+*  Example:
+*    int len = list_sprint(NULL, 0, list, "%d", ", ");
+*    char* text = (char*)malloc(len + 1);
+*    list_sprint(text, len + 1, list, "%d", ", ");
+*  Parameters:
+*    buffer ---> The target buffer
+*    capacity ---> The size of the buffer
+*    list ---> The input list_t
+*    pattern ---> The pattern to use to print each item
+*    separator ---> The text to write between two items, or NULL */
+int list_sprint(char* buffer, int capacity, list_t list, char* pattern, char* separator);
+
+/* ---------------------------------------------------------------------
+*  ListParse
+*  ---------------------------------------------------------------------
+*  Description:
+*    Creates a new list_t with the items inside the given text, which
+*    are divided by the separator. The spaces around each item are
+*    ignored, as well as the empty items, so a trailing separator or an
+*    empty line are allowed. The items are collected in large blocks and
+*    the nodes of each block are allocated at once.
+*    If the parser is NULL and T is int, the items are parsed as base 10
+*    integers with a custom loop that doesn't use scanf. Otherwise, the
+*    parser receives the text of each item (that is not terminated by
+*    '\0') and it has to return FALSE if the item is not valid.
+*    Returns NULL if the buffer is NULL, if an item is not valid, or if
+*    the parser is NULL and T is not int.
+*  Example:
+*    list_t list = list_parse("1, 2, -3", 8, ',', NULL);
+*  Parameters:
+*    buffer ---> The text to parse
+*    len ---> The length of the text
+*    separator ---> The character that divides two items
+*    parser ---> The function that parses a single item, or NULL */
+list_t list_parse(const char* buffer, size_t len, char separator, bool_t(*parser)(const char*, int, T*));
+
+/* ---------------------------------------------------------------------
+*  ListRead
+*  ---------------------------------------------------------------------
+*  Description:
+*    Same as list_parse, but it reads the text from the given stream
+*    until its end, in large chunks. Returns NULL if the stream is NULL
+*    or if it can't be read, with the same rules of list_parse.
+*  Example:
+*    list_t list = list_read(stdin, '\n', NULL);
+*  NOTE:
+*    A file descriptor can be used by opening a stream with fdopen.
+*  Parameters:
+*    stream ---> The input stream
+*    separator ---> The character that divides two items
+*    parser ---> The function that parses a single item, or NULL */
+list_t list_read(FILE* stream, char separator, bool_t(*parser)(const char*, int, T*));
+
 /* =====================================================================
 *  stack_t
 *  =====================================================================
@@ -773,7 +971,10 @@ list_t join_where(list_t list1, list_t list2, bool_t(*condition)(T), bool_t(*exp
 *  Parameters:
 *    list1 ---> The first input list_t
 *    list2 ---> The second list_t, it can have an arbitrary length
-*    expression ---> EqualityTester lambda expression */
+*    expression ---> EqualityTester lambda expression. If NULL, the items
+*                    are compared with ==, and the Bloom filter or the
+*                    hash index of list2 are used to skip the items that
+*                    are not inside it */
 list_t intersect(list_t list1, list_t list2, bool_t(*expression)(T, T));
 
 /* ---------------------------------------------------------------------
@@ -787,7 +988,10 @@ list_t intersect(list_t list1, list_t list2, bool_t(*expression)(T, T));
 *  Parameters:
 *    list1 ---> The first input list_t
 *    list2 ---> The second list_t, it can have an arbitrary length
-*    expression ---> EqualityTester lambda expression */
+*    expression ---> EqualityTester lambda expression. If NULL, the items
+*                    are compared with ==, and the Bloom filter or the
+*                    hash index of list2 are used to skip the items that
+*                    are not inside it */
 list_t except(list_t list1, list_t list2, bool_t(*expression)(T, T));
 
 /* ---------------------------------------------------------------------
@@ -1038,6 +1242,349 @@ bool_t sequence_equals(list_t list1, list_t list2, bool_t(*expression)(T, T));
 *    length ---> The maximum length for the new list_t */
 list_t trim(list_t list, int length);
 
+/* =====================================================================
+*  LINQ with context
+*  =====================================================================
+*  Description:
+*    Variants of the LINQ functions that take a standard function
+*    together with a void* context argument, which is passed unchanged
+*    to every call of the function. The context can be used to store
+*    the state that would otherwise be captured by a lambda expression.
+*  How-To:
+*    Unlike the lambda macros above, these functions don't require
+*    nested functions and executable stack trampolines: the callbacks
+*    can be inlined by the compiler and safely shared between threads.
+*  Example (assuming T is int):
+*    bool_t greater_than(T item, void* ctx) { return item > *(int*)ctx; }
+*    ...
+*    int threshold = 10;
+*    list_t result = where_ctx(list, greater_than, &threshold);
+*  NOTE:
+*    Each function has the same behavior and return values of the
+*    LINQ function with the same name, without the _ctx suffix. */
+
+/* ---------------------------------------------------------------------
+*  FirstOrDefaultCtx
+*  ---------------------------------------------------------------------
+*  Parameters:
+*    list ---> The input list_t
+*    result ---> Pointer to the result T value
+*    expression ---> Selector function
+*    ctx ---> The context to pass to the expression */
+bool_t first_or_default_ctx(list_t list, T* result, bool_t(*expression)(T, void*), void* ctx);
+
+/* ---------------------------------------------------------------------
+*  CountCtx
+*  ---------------------------------------------------------------------
+*  Parameters:
+*    list ---> The input list_t
+*    expression ---> Selector function
+*    ctx ---> The context to pass to the expression */
+int count_ctx(list_t list, bool_t(*expression)(T, void*), void* ctx);
+
+/* ---------------------------------------------------------------------
+*  WhereCtx
+*  ---------------------------------------------------------------------
+*  Parameters:
+*    list ---> The input list_t
+*    expression ---> Selector function
+*    ctx ---> The context to pass to the expression */
+list_t where_ctx(list_t list, bool_t(*expression)(T, void*), void* ctx);
+
+/* ---------------------------------------------------------------------
+*  AnyCtx
+*  ---------------------------------------------------------------------
+*  Parameters:
+*    list ---> The input list_t
+*    expression ---> Selector function
+*    ctx ---> The context to pass to the expression */
+bool_t any_ctx(list_t list, bool_t(*expression)(T, void*), void* ctx);
+
+/* ---------------------------------------------------------------------
+*  AllCtx
+*  ---------------------------------------------------------------------
+*  Parameters:
+*    list ---> The input list_t
+*    expression ---> Selector function
+*    ctx ---> The context to pass to the expression */
+bool_t all_ctx(list_t list, bool_t(*expression)(T, void*), void* ctx);
+
+/* ---------------------------------------------------------------------
+*  ForEachCtx
+*  ---------------------------------------------------------------------
+*  Parameters:
+*    list ---> The input list_t
+*    expression ---> Block function
+*    ctx ---> The context to pass to the expression */
+bool_t for_each_ctx(list_t list, void(*expression)(T, void*), void* ctx);
+
+/* ---------------------------------------------------------------------
+*  RemoveWhereCtx
+*  ---------------------------------------------------------------------
+*  Parameters:
+*    list ---> The input list_t
+*    expression ---> Selector function
+*    ctx ---> The context to pass to the expression */
+list_t remove_where_ctx(list_t list, bool_t(*expression)(T, void*), void* ctx);
+
+/* ---------------------------------------------------------------------
+*  DeriveCtx
+*  ---------------------------------------------------------------------
+*  Parameters:
+*    list ---> The input list_t
+*    expression ---> Deriver function
+*    ctx ---> The context to pass to the expression */
+list_t derive_ctx(list_t list, T(*expression)(T, void*), void* ctx);
+
+/* ---------------------------------------------------------------------
+*  DistinctCtx
+*  ---------------------------------------------------------------------
+*  Parameters:
+*    list ---> The input list_t
+*    expression ---> EqualityTester function
+*    ctx ---> The context to pass to the expression */
+list_t distinct_ctx(list_t list, bool_t(*expression)(T, T, void*), void* ctx);
+
+/* ---------------------------------------------------------------------
+*  OrderByCtx
+*  ---------------------------------------------------------------------
+*  Parameters:
+*    list ---> The input list_t
+*    expression ---> Comparator function
+*    ctx ---> The context to pass to the expression */
+list_t order_by_ctx(list_t list, comparation(*expression)(T, T, void*), void* ctx);
+
+/* ---------------------------------------------------------------------
+*  OrderByDescendingCtx
+*  ---------------------------------------------------------------------
+*  Parameters:
+*    list ---> The input list_t
+*    expression ---> Comparator function
+*    ctx ---> The context to pass to the expression */
+list_t order_by_descending_ctx(list_t list, comparation(*expression)(T, T, void*), void* ctx);
+
+/* =====================================================================
+*  Batch LINQ
+*  =====================================================================
+*  Description:
+*    Variants of the filtering functions that pass the items to their
+*    expression in blocks of up to LIST_BATCH_SIZE elements, instead of
+*    calling it once per item. The expression receives a contiguous
+*    array of items and fills a mask with one bool_t for each of them,
+*    so that a simple condition can be vectorized by the compiler.
+*  NOTE:
+*    Each function has the same behavior and return values of the
+*    LINQ function with the same name, without the _batch suffix. */
+
+// The maximum number of items passed to a BatchSelector expression
+#ifndef LIST_BATCH_SIZE
+#define LIST_BATCH_SIZE 16
+#endif
+
+/* ---------------------------------------------------------------------
+*  BatchSelector
+*  ---------------------------------------------------------------------
+*  Description:
+*    Represents a function that takes an array of items, its length and
+*    an output mask, and sets mask[i] to TRUE if items[i] satisfies the
+*    condition, FALSE otherwise.
+*  Example (assuming T is int):
+*    batchSelector(items, n, mask,
+*    {
+*        int i;
+*        for (i = 0; i < n; i++) mask[i] = items[i] > 10;
+*    }) */
+#define batchSelector(items_name, len_name, mask_name, func_body) \
+lambda(void, (const T* items_name, int len_name, bool_t* mask_name) func_body)
+
+/* ---------------------------------------------------------------------
+*  CountBatch
+*  ---------------------------------------------------------------------
+*  Parameters:
+*    list ---> The input list_t
+*    expression ---> BatchSelector lambda expression */
+int count_batch(list_t list, void(*expression)(const T*, int, bool_t*));
+
+/* ---------------------------------------------------------------------
+*  WhereBatch
+*  ---------------------------------------------------------------------
+*  Parameters:
+*    list ---> The input list_t
+*    expression ---> BatchSelector lambda expression */
+list_t where_batch(list_t list, void(*expression)(const T*, int, bool_t*));
+
+/* ---------------------------------------------------------------------
+*  RemoveWhereBatch
+*  ---------------------------------------------------------------------
+*  Parameters:
+*    list ---> The input list_t
+*    expression ---> BatchSelector lambda expression */
+list_t remove_where_batch(list_t list, void(*expression)(const T*, int, bool_t*));
+
+/* ---------------------------------------------------------------------
+*  ReplaceWhereBatch
+*  ---------------------------------------------------------------------
+*  Parameters:
+*    list ---> The input list_t
+*    replacement ---> The value to use when replacing an item
+*    expression ---> BatchSelector lambda expression */
+list_t replace_where_batch(list_t list, const T replacement, void(*expression)(const T*, int, bool_t*));
+
+/* =====================================================================
+*  In-place LINQ
+*  =====================================================================
+*  Description:
+*    Variants of the LINQ functions that edit the input list_t directly,
+*    instead of returning a new one. They work in a single pass and
+*    don't allocate any memory: the removed nodes are deallocated and
+*    the other ones are reused.
+*  NOTE:
+*    Unlike the functions inside the LINQ section, these functions work
+*    with SIDE EFFECT. */
+
+/* ---------------------------------------------------------------------
+*  FilterInPlace
+*  ---------------------------------------------------------------------
+*  Description:
+*    Removes from the list_t all the items that DON'T satisfy the given
+*    expression, so that it contains the result of the where function.
+*    Returns the number of removed items, or -1 if the list_t is NULL.
+*  Parameters:
+*    list ---> The list_t to edit
+*    expression ---> Selector lambda expression */
+int filter_in_place(list_t list, bool_t(*expression)(T));
+
+/* ---------------------------------------------------------------------
+*  RemoveWhereInPlace
+*  ---------------------------------------------------------------------
+*  Description:
+*    Removes from the list_t all the items that satisfy the given
+*    expression. Returns the number of removed items, or -1 if the
+*    list_t is NULL.
+*  Parameters:
+*    list ---> The list_t to edit
+*    expression ---> Selector lambda expression */
+int remove_where_in_place(list_t list, bool_t(*expression)(T));
+
+/* ---------------------------------------------------------------------
+*  ReplaceWhereInPlace
+*  ---------------------------------------------------------------------
+*  Description:
+*    Replaces all the items that satisfy the given expression with the
+*    given value. Returns the number of replaced items, or -1 if the
+*    list_t is NULL.
+*  Parameters:
+*    list ---> The list_t to edit
+*    replacement ---> The value to use when replacing an item
+*    expression ---> Selector lambda expression */
+int replace_where_in_place(list_t list, const T replacement, bool_t(*expression)(T));
+
+/* ---------------------------------------------------------------------
+*  DeriveInPlace
+*  ---------------------------------------------------------------------
+*  Description:
+*    Replaces each item with the result of the given expression.
+*    Returns FALSE if the list_t is NULL or empty.
+*  Parameters:
+*    list ---> The list_t to edit
+*    expression ---> Deriver lambda expression */
+bool_t derive_in_place(list_t list, T(*expression)(T));
+
+/* ---------------------------------------------------------------------
+*  ReverseInPlace
+*  ---------------------------------------------------------------------
+*  Description:
+*    Reverses the order of the items inside the list_t in O(n), by
+*    relinking its nodes. Returns FALSE if the list_t is NULL or empty.
+*  Parameters:
+*    list ---> The list_t to edit */
+bool_t reverse_in_place(list_t list);
+
+/* ---------------------------------------------------------------------
+*  ReverseRangeInPlace
+*  ---------------------------------------------------------------------
+*  Description:
+*    Reverses the order of the items between the two given indexes,
+*    including them, in O(n). Returns FALSE if the list_t is NULL or
+*    empty or if the indexes are not valid.
+*  Parameters:
+*    list ---> The list_t to edit
+*    start ---> The start index for the reversed section
+*    end ---> The index of the last element with the reversed order */
+bool_t reverse_range_in_place(list_t list, int start, int end);
+
+/* =====================================================================
+*  LINQ into an existing list_t
+*  =====================================================================
+*  Description:
+*    Variants of the LINQ functions that store their result inside a
+*    list_t provided by the caller instead of creating a new one. The
+*    destination list_t is cleared and refilled, reusing its nodes:
+*    new nodes are only allocated if the result is longer than the
+*    previous content of the destination list_t, and the extra nodes
+*    are deallocated if it is shorter. This way the same destination
+*    can be used to run a query many times without allocating memory.
+*  NOTE:
+*    Each function returns TRUE if the operation was successful, and
+*    FALSE if either one of the two list_ts is NULL, if they are the
+*    same list_t or if the other parameters are not valid. If the source
+*    list_t is empty, the destination list_t is left empty.
+*    These functions work with SIDE EFFECT on the destination list_t. */
+
+/* ---------------------------------------------------------------------
+*  WhereInto
+*  ---------------------------------------------------------------------
+*  Parameters:
+*    destination ---> The list_t that will store the result
+*    list ---> The input list_t
+*    expression ---> Selector lambda expression */
+bool_t where_into(list_t destination, list_t list, bool_t(*expression)(T));
+
+/* ---------------------------------------------------------------------
+*  RemoveWhereInto
+*  ---------------------------------------------------------------------
+*  Parameters:
+*    destination ---> The list_t that will store the result
+*    list ---> The input list_t
+*    expression ---> Selector lambda expression */
+bool_t remove_where_into(list_t destination, list_t list, bool_t(*expression)(T));
+
+/* ---------------------------------------------------------------------
+*  DeriveInto
+*  ---------------------------------------------------------------------
+*  Parameters:
+*    destination ---> The list_t that will store the result
+*    list ---> The input list_t
+*    expression ---> Deriver lambda expression */
+bool_t derive_into(list_t destination, list_t list, T(*expression)(T));
+
+/* ---------------------------------------------------------------------
+*  TakeRangeInto
+*  ---------------------------------------------------------------------
+*  Parameters:
+*    destination ---> The list_t that will store the result
+*    list ---> The input list_t
+*    start ---> The starting index
+*    end ---> The final index (should be greater than the first one) */
+bool_t take_range_into(list_t destination, list_t list, int start, int end);
+
+/* ---------------------------------------------------------------------
+*  ReverseInto
+*  ---------------------------------------------------------------------
+*  Parameters:
+*    destination ---> The list_t that will store the result
+*    list ---> The input list_t */
+bool_t reverse_into(list_t destination, list_t list);
+
+/* ---------------------------------------------------------------------
+*  OrderByInto
+*  ---------------------------------------------------------------------
+*  Parameters:
+*    destination ---> The list_t that will store the result
+*    list ---> The input list_t
+*    expression ---> Comparator lambda expression */
+bool_t order_by_into(list_t destination, list_t list, comparation(*expression)(T, T));
+
 /* =====================================================================
 *  Iterator
 *  =====================================================================
@@ -1052,6 +1599,46 @@ list_t trim(list_t list, int length);
 *    languages, this is done in order to prevent unwanted side effects
 *    when using the Iterator. */
 
+/* ---------------------------------------------------------------------
+*  listIterator
+*  ---------------------------------------------------------------------
+*  Description:
+*    The struct behind a list_iterator_t. It stores a pointer to the
+*    target node, one to the target list, the current position inside
+*    the list, a sync variable that checks if the iterator is still
+*    valid and a started variable used to calculate the next node to
+*    return. Its layout is public so that an iterator can be declared
+*    on the stack and initialized with the iterator_init function:
+*    its fields should NOT be edited directly.
+*  Example:
+*    struct listIterator iterator;
+*    if (iterator_init(&iterator, list))
+*    {
+*        while (next(&iterator, &item)) ...
+*    } */
+struct listIterator
+{
+	struct listElem* pointer;
+	list_t list;
+	int position;
+	unsigned int sync;
+	bool_t started;
+};
+
+/* ---------------------------------------------------------------------
+*  IteratorInit
+*  ---------------------------------------------------------------------
+*  Description:
+*    Initializes a caller-owned Iterator for the given list_t, without
+*    allocating any memory. The Iterator behaves exactly like the ones
+*    returned by get_iterator, but it must NOT be passed to the
+*    destroy_iterator function. Returns FALSE if the Iterator is NULL or
+*    if the list_t is NULL or empty.
+*  Parameters:
+*    iterator ---> Pointer to the Iterator to initialize
+*    list ---> The source list_t */
+bool_t iterator_init(list_iterator_t iterator, list_t list);
+
 /* ---------------------------------------------------------------------
 *  GetIterator
 *  ---------------------------------------------------------------------
@@ -1177,6 +1764,86 @@ int actual_position(list_iterator_t iterator);
 *    iterator ---> The input iterator */
 int elements_left(list_iterator_t iterator);
 
+/* ---------------------------------------------------------------------
+*  NextBatch
+*  ---------------------------------------------------------------------
+*  Description:
+*    Copies into the buffer up to max items, the same ones that would
+*    be returned by calling the next function max times, and moves the
+*    Iterator to the last copied item. The Iterator is only checked
+*    once, so this is faster than calling next for each item.
+*    Returns the number of copied items (0 if there isn't another item
+*    left inside the list_t), or -1 if the Iterator or the buffer is
+*    NULL, or if the Iterator is out of sync.
+*  Parameters:
+*    iterator ---> The input iterator
+*    buffer ---> The array where to copy the items
+*    max ---> The maximum number of items to copy */
+int next_batch(list_iterator_t iterator, T* buffer, int max);
+
+/* ---------------------------------------------------------------------
+*  PrevBatch
+*  ---------------------------------------------------------------------
+*  Description:
+*    Moves the Iterator back up to max times and copies into the buffer
+*    each item it reaches, in reverse order. Returns the number of
+*    copied items (0 if the Iterator already points to the first item),
+*    or -1 if the Iterator or the buffer is NULL, or if the Iterator is
+*    out of sync.
+*  Parameters:
+*    iterator ---> The input iterator
+*    buffer ---> The array where to copy the items
+*    max ---> The maximum number of items to copy */
+int prev_batch(list_iterator_t iterator, T* buffer, int max);
+
+/* ---------------------------------------------------------------------
+*  IteratorInsertBefore
+*  ---------------------------------------------------------------------
+*  Description:
+*    Inserts an item before the current one, in O(1). The Iterator
+*    keeps pointing to the same item and stays synced with the list_t,
+*    while all the other Iterators of the list_t become invalid.
+*    If the list_t has been emptied by iterator_remove, the item becomes
+*    its only element and the next function will return it.
+*    Returns FALSE if the Iterator is NULL or out of sync.
+*  Parameters:
+*    iterator ---> The input iterator
+*    item ---> The item to add */
+bool_t iterator_insert_before(list_iterator_t iterator, const T item);
+
+/* ---------------------------------------------------------------------
+*  IteratorInsertAfter
+*  ---------------------------------------------------------------------
+*  Description:
+*    Inserts an item after the current one, in O(1), so that it will be
+*    returned by the following call to the next function. Just like
+*    iterator_insert_before, the Iterator stays valid while all the
+*    other Iterators of the list_t become invalid.
+*    Returns FALSE if the Iterator is NULL or out of sync.
+*  Parameters:
+*    iterator ---> The input iterator
+*    item ---> The item to add */
+bool_t iterator_insert_after(list_iterator_t iterator, const T item);
+
+/* ---------------------------------------------------------------------
+*  IteratorRemove
+*  ---------------------------------------------------------------------
+*  Description:
+*    Removes the current item from the list_t, in O(1). The Iterator is
+*    moved so that the following call to the next function returns the
+*    item that came after the removed one, and it stays synced with the
+*    list_t while all the other Iterators become invalid.
+*    Returns FALSE if the Iterator is NULL, out of sync or if its
+*    list_t is empty.
+*  Example (removes all the negative items in a single pass):
+*    while (next(iterator, &item))
+*    {
+*        if (item < 0) iterator_remove(iterator);
+*    }
+*  Parameters:
+*    iterator ---> The input iterator */
+bool_t iterator_remove(list_iterator_t iterator);
+
 /* ---------------------------------------------------------------------
 *  ForEachRemaining
 *  ---------------------------------------------------------------------
@@ -1200,6 +1867,501 @@ int for_each_remaining(list_iterator_t iterator, void(*expression)(T));
 *    iterator ---> The input iterator */
 bool_t restart(list_iterator_t iterator);
 
+/* =====================================================================
+*  Span iterator
+*  =====================================================================
+*  Description:
+*    Functions that create and manage a list_span_iterator_t, an
+*    iterator that returns the items of a list_t in contiguous blocks
+*    instead of one at a time. Each block can be used inside a tight
+*    loop, copied with memcpy or written to a file with a single call.
+*  NOTE:
+*    The items are copied from the list_t nodes into a buffer, which is
+*    overwritten by each call to next_span. Just like a list_iterator_t,
+*    a span iterator becomes invalid if its list_t is modified. */
+
+/* ---------------------------------------------------------------------
+*  GetSpanIterator
+*  ---------------------------------------------------------------------
+*  Description:
+*    Creates and returns a new span iterator for the given list_t.
+*    Returns NULL if the list_t is NULL, or if a buffer is given with
+*    a capacity <= 0.
+*  Parameters:
+*    list ---> The source list_t
+*    buffer ---> The buffer to use to store each block. If NULL, the
+*                iterator will allocate its own buffer
+*    capacity ---> The maximum length of each block. If buffer is not
+*                  NULL, it must have room for at least capacity items.
+*                  If buffer is NULL and capacity is <= 0, a default
+*                  capacity is used */
+list_span_iterator_t get_span_iterator(list_t list, T* buffer, int capacity);
+
+/* ---------------------------------------------------------------------
+*  NextSpan
+*  ---------------------------------------------------------------------
+*  Description:
+*    Assigns to data the next block of items and to len its length.
+*    Returns FALSE if the iterator is NULL, out of sync or if there
+*    are no items left inside the list_t.
+*  Example:
+*    const T* data;
+*    int len, i;
+*    while (next_span(iterator, &data, &len))
+*    {
+*        for (i = 0; i < len; i++) total += data[i];
+*    }
+*  Parameters:
+*    iterator ---> The input span iterator
+*    data ---> Pointer to the first item of the block
+*    len ---> Pointer to an int to store the length of the block */
+bool_t next_span(list_span_iterator_t iterator, const T** data, int* len);
+
+/* ---------------------------------------------------------------------
+*  DestroySpanIterator
+*  ---------------------------------------------------------------------
+*  Description:
+*    Deallocates a span iterator and sets it to NULL. The buffer is
+*    deallocated only if it was allocated by the iterator.
+*    It returns FALSE if the iterator was already NULL.
+*  Parameters:
+*    iterator ---> A pointer to the target span iterator */
+bool_t destroy_span_iterator(list_span_iterator_t* iterator);
+
+/* =====================================================================
+*  Hash index
+*  =====================================================================
+*  Description:
+*    Functions that attach a hash index to a list_t. The index maps each
+*    item to its nodes and it is updated by every function that edits
+*    the list_t, so that is_element, remove_item, replace_item and
+*    remove_all_items take expected O(1) time instead of scanning the
+*    whole list_t. index_of and last_index_of return -1 in O(1) time
+*    when the item is not inside the list_t.
+*  NOTE:
+*    The index costs some memory for each item and makes each insertion
+*    and removal a bit slower, so it should only be enabled on a list_t
+*    that is searched by value very often (e.g. to skip duplicates
+*    with is_element before each add). */
+
+/* ---------------------------------------------------------------------
+*  EnableHashIndex
+*  ---------------------------------------------------------------------
+*  Description:
+*    Builds a hash index with the current items of the list_t and keeps
+*    it updated until disable_hash_index or destroy are called.
+*    If the list_t already had an index, it is rebuilt with the new hash
+*    function. Returns FALSE if the list_t or the function are NULL.
+*  NOTE:
+*    The hash function is stored inside the list_t, so it must be a
+*    standard function and not a selector-like lambda that goes out of
+*    scope. Equal items must always have the same hash.
+*  Example (assuming T is int):
+*    unsigned int int_hash(int value) { return (unsigned int)value * 2654435761u; }
+*    enable_hash_index(list, int_hash);
+*  Parameters:
+*    list ---> The target list_t
+*    hash ---> The hash function to use */
+bool_t enable_hash_index(list_t list, unsigned int(*hash)(T));
+
+/* ---------------------------------------------------------------------
+*  DisableHashIndex
+*  ---------------------------------------------------------------------
+*  Description:
+*    Deallocates the hash index of the list_t. Returns FALSE if the
+*    list_t is NULL or if it didn't have an index.
+*  Parameters:
+*    list ---> The target list_t */
+bool_t disable_hash_index(list_t list);
+
+/* =====================================================================
+*  Bloom filter
+*  =====================================================================
+*  Description:
+*    Functions that attach a Bloom filter to a list_t. The filter is
+*    updated each time an item is added to the list_t and it lets
+*    is_element, index_of, last_index_of, remove_item, replace_item,
+*    intersect and except (with a NULL expression) reject most of the
+*    items that are not inside the list_t without walking it.
+*    It uses much less memory than a hash index, but it can't speed up
+*    the lookups of the items that are inside the list_t.
+*  NOTE:
+*    The removed items are never cleared from the filter, so after many
+*    removals it rejects fewer items: call rebuild_bloom_filter to build
+*    it again with the current items. When more items than the expected
+*    capacity are added, the filter doubles its size on its own, up to
+*    2^31 bits (256 MB): past that size its false positive rate grows. */
+
+/* ---------------------------------------------------------------------
+*  EnableBloomFilter
+*  ---------------------------------------------------------------------
+*  Description:
+*    Builds a Bloom filter with the current items of the list_t and keeps
+*    it updated until disable_bloom_filter or destroy are called.
+*    If the list_t already had a filter, it is replaced.
+*    Returns FALSE if the list_t or the function are NULL, if the rate
+*    is not between 0 and 1 or if the filter can't be allocated, in which
+*    case the previous filter of the list_t (if any) is left in place.
+*  NOTE:
+*    Just like with enable_hash_index, the hash function must be a
+*    standard function and equal items must have the same hash.
+*  Example (assuming T is int and int_hash is a hash function):
+*    enable_bloom_filter(list, int_hash, 10000, 0.01f);
+*  Parameters:
+*    list ---> The target list_t
+*    hash ---> The hash function to use
+*    capacity ---> The expected number of items. If <= 0, a default
+*                  value is used
+*    rate ---> The expected rate of false positives (e.g. 0.01 means
+*              that about 1% of the missing items will not be rejected) */
+bool_t enable_bloom_filter(list_t list, unsigned int(*hash)(T), int capacity, float rate);
+
+/* ---------------------------------------------------------------------
+*  RebuildBloomFilter
+*  ---------------------------------------------------------------------
+*  Description:
+*    Clears the Bloom filter of the list_t and adds its current items.
+*    Returns FALSE if the list_t is NULL or if it didn't have a filter.
+*  Parameters:
+*    list ---> The target list_t */
+bool_t rebuild_bloom_filter(list_t list);
+
+/* ---------------------------------------------------------------------
+*  DisableBloomFilter
+*  ---------------------------------------------------------------------
+*  Description:
+*    Deallocates the Bloom filter of the list_t. Returns FALSE if the
+*    list_t is NULL or if it didn't have a filter.
+*  Parameters:
+*    list ---> The target list_t */
+bool_t disable_bloom_filter(list_t list);
+
+/* =====================================================================
+*  Incremental aggregates
+*  =====================================================================
+*  Description:
+*    Functions that register a list_aggregate_t on a list_t. An aggregate
+*    stores the count, sum, minimum and maximum of the values that a
+*    toNumber function returns for the items of the list_t, and it is
+*    updated by every function that edits the list_t. The sum and the
+*    count are updated in O(1), the minimum and the maximum in O(log n)
+*    and all of them are returned in O(1) time, while the sum, average,
+*    get_numeric_min and get_numeric_max functions walk the whole list_t.
+*  NOTE:
+*    The toNumber function is stored inside the aggregate, so it must be
+*    a standard function and not a lambda that goes out of scope, and it
+*    must always return the same value for the same item.
+*    All the aggregates are deallocated when their list_t is destroyed.
+*  Example (assuming T is int and identity returns its argument):
+*    list_aggregate_t stats = register_aggregate(list, identity);
+*    add(10, list);
+*    printf("%d %d", aggregate_sum(stats), aggregate_max(stats)); */
+
+/* ---------------------------------------------------------------------
+*  RegisterAggregate
+*  ---------------------------------------------------------------------
+*  Description:
+*    Creates a new aggregate with the current items of the list_t and
+*    attaches it to the list_t. Returns NULL if the list_t or the
+*    function are NULL.
+*  Parameters:
+*    list ---> The target list_t
+*    expression ---> ToNumber function */
+list_aggregate_t register_aggregate(list_t list, int(*expression)(T));
+
+/* ---------------------------------------------------------------------
+*  UnregisterAggregate
+*  ---------------------------------------------------------------------
+*  Description:
+*    Detaches the aggregate from the list_t, deallocates it and sets it
+*    to NULL. Returns FALSE if the list_t or the aggregate are NULL, or
+*    if the aggregate doesn't belong to the list_t.
+*  Parameters:
+*    list ---> The list_t the aggregate was registered on
+*    aggregate ---> A pointer to the target aggregate */
+bool_t unregister_aggregate(list_t list, list_aggregate_t* aggregate);
+
+/* ---------------------------------------------------------------------
+*  AggregateCount
+*  ---------------------------------------------------------------------
+*  Description:
+*    Returns the number of items in the list_t, or -1 if the aggregate
+*    is NULL.
+*  Parameters:
+*    aggregate ---> The input aggregate */
+int aggregate_count(list_aggregate_t aggregate);
+
+/* ---------------------------------------------------------------------
+*  AggregateSum
+*  ---------------------------------------------------------------------
+*  Description:
+*    Returns the sum of the values, or 0 if the aggregate is NULL
+*    or if the list_t is empty.
+*  Parameters:
+*    aggregate ---> The input aggregate */
+int aggregate_sum(list_aggregate_t aggregate);
+
+/* ---------------------------------------------------------------------
+*  AggregateAverage
+*  ---------------------------------------------------------------------
+*  Description:
+*    Returns the average of the values, or 0 if the aggregate is NULL
+*    or if the list_t is empty.
+*  Parameters:
+*    aggregate ---> The input aggregate */
+int aggregate_average(list_aggregate_t aggregate);
+
+/* ---------------------------------------------------------------------
+*  AggregateMin
+*  ---------------------------------------------------------------------
+*  Description:
+*    Returns the minimum value, or 0 if the aggregate is NULL
+*    or if the list_t is empty.
+*  Parameters:
+*    aggregate ---> The input aggregate */
+int aggregate_min(list_aggregate_t aggregate);
+
+/* ---------------------------------------------------------------------
+*  AggregateMax
+*  ---------------------------------------------------------------------
+*  Description:
+*    Returns the maximum value, or 0 if the aggregate is NULL
+*    or if the list_t is empty.
+*  Parameters:
+*    aggregate ---> The input aggregate */
+int aggregate_max(list_aggregate_t aggregate);
+
+/* =====================================================================
+*  Range queries
+*  =====================================================================
+*  Description:
+*    Functions that return the sum, minimum or maximum of the values
+*    that a toNumber function returns for the items inside a range of
+*    indexes, in O(log n) time. They use a segment tree attached to the
+*    list_t, while sum(take_range(list, start, end), expression) has to
+*    copy the range and walk it.
+*  NOTE:
+*    replace_at updates the tree in O(log n) time. Any other edit marks
+*    the tree as outdated, and the next query rebuilds it in O(n) time:
+*    the range queries are fast on a list_t that is mostly edited with
+*    replace_at, or that is queried many times between two edits. */
+
+/* ---------------------------------------------------------------------
+*  EnableRangeQueries
+*  ---------------------------------------------------------------------
+*  Description:
+*    Attaches a segment tree to the list_t, it will be built with the
+*    first query. If the list_t already had a tree, it is replaced.
+*    Returns FALSE if the list_t or the function are NULL.
+*  NOTE:
+*    Just like with register_aggregate, the toNumber function must be
+*    a standard function and not a lambda that goes out of scope.
+*  Parameters:
+*    list ---> The target list_t
+*    expression ---> ToNumber function */
+bool_t enable_range_queries(list_t list, int(*expression)(T));
+
+/* ---------------------------------------------------------------------
+*  DisableRangeQueries
+*  ---------------------------------------------------------------------
+*  Description:
+*    Deallocates the segment tree of the list_t. Returns FALSE if the
+*    list_t is NULL or if it didn't have a tree.
+*  Parameters:
+*    list ---> The target list_t */
+bool_t disable_range_queries(list_t list);
+
+/* ---------------------------------------------------------------------
+*  RangeSum
+*  ---------------------------------------------------------------------
+*  Description:
+*    Assigns to result the sum of the values of the items between the
+*    start and end indexes, both included. Returns FALSE if the list_t
+*    is NULL, if range queries are not enabled or if the range is not
+*    valid (start can be equal to end).
+*  Parameters:
+*    list ---> The input list_t
+*    start ---> The index of the first item in the range
+*    end ---> The index of the last item in the range
+*    result ---> Pointer to an int to store the result */
+bool_t range_sum(list_t list, int start, int end, int* result);
+
+/* ---------------------------------------------------------------------
+*  RangeMin
+*  ---------------------------------------------------------------------
+*  Description:
+*    Same as range_sum, but it returns the minimum value in the range.
+*  Parameters:
+*    list ---> The input list_t
+*    start ---> The index of the first item in the range
+*    end ---> The index of the last item in the range
+*    result ---> Pointer to an int to store the result */
+bool_t range_min(list_t list, int start, int end, int* result);
+
+/* ---------------------------------------------------------------------
+*  RangeMax
+*  ---------------------------------------------------------------------
+*  Description:
+*    Same as range_sum, but it returns the maximum value in the range.
+*  Parameters:
+*    list ---> The input list_t
+*    start ---> The index of the first item in the range
+*    end ---> The index of the last item in the range
+*    result ---> Pointer to an int to store the result */
+bool_t range_max(list_t list, int start, int end, int* result);
+
+/* =====================================================================
+*  Views
+*  =====================================================================
+*  Description:
+*    Functions that create and manage a list_view_t, a list_t that
+*    always contains the result of where and derive on a source list_t.
+*    Each edit of the source list_t is applied to the view, instead of
+*    calling where or derive again in O(n): a removal or a replacement
+*    is O(1) expected time, while an item added to the source list_t
+*    costs O(d), where d is the distance from the new item to the
+*    closest source item that is inside the view (or to the end of the
+*    source list_t). This is O(1) when adding at the end or at the start,
+*    but it can be up to O(n) with a very selective predicate.
+*  NOTE:
+*    The list_t returned by view_list must only be read: it must not be
+*    edited or destroyed, since it belongs to the view.
+*    reverse_in_place on the source list_t rebuilds the views in O(n).
+*    If the source list_t is destroyed, its views are emptied and they
+*    are no longer updated, but they still have to be destroyed. */
+
+/* ---------------------------------------------------------------------
+*  CreateView
+*  ---------------------------------------------------------------------
+*  Description:
+*    Creates a view of the source list_t, with the derived items that
+*    satisfy the predicate. Returns NULL if the source list_t is NULL.
+*  NOTE:
+*    The functions are stored inside the view, so they must be standard
+*    functions and not lambdas that go out of scope.
+*  Example (assuming T is int, is_even and square are two functions):
+*    list_view_t view = create_view(list, is_even, square);
+*    add(4, list);
+*    formatted_print("%d", view_list(view));
+*  Parameters:
+*    source ---> The source list_t
+*    predicate ---> Selector lambda expression, if NULL all the items
+*                   of the source list_t are inside the view
+*    deriver ---> Deriver lambda expression, if NULL the items are not
+*                 transformed */
+list_view_t create_view(list_t source, bool_t(*predicate)(T), T(*deriver)(T));
+
+/* ---------------------------------------------------------------------
+*  ViewList
+*  ---------------------------------------------------------------------
+*  Description:
+*    Returns the list_t with the items of the view, or NULL if the
+*    view is NULL.
+*  Parameters:
+*    view ---> The input view */
+list_t view_list(list_view_t view);
+
+/* ---------------------------------------------------------------------
+*  RefreshView
+*  ---------------------------------------------------------------------
+*  Description:
+*    Builds the view again from its source list_t. It is only needed
+*    if the predicate or the deriver depend on some external state that
+*    has changed. Returns FALSE if the view is NULL or if its source
+*    list_t has been destroyed.
+*  Parameters:
+*    view ---> The target view */
+bool_t refresh_view(list_view_t view);
+
+/* ---------------------------------------------------------------------
+*  DestroyView
+*  ---------------------------------------------------------------------
+*  Description:
+*    Detaches the view from its source list_t, deallocates it and sets
+*    it to NULL. It returns FALSE if the view was already NULL.
+*  Parameters:
+*    view ---> A pointer to the target view */
+bool_t destroy_view(list_view_t* view);
+
+/* =====================================================================
+*  Observers
+*  =====================================================================
+*  Description:
+*    Functions that register an observer on a list_t. An observer is a
+*    function that receives an event for each item that is added,
+*    removed or replaced, by any function that edits the list_t, so
+*    that a cache or a copy of the list_t can be updated without walking
+*    the whole list_t again.
+*  How-To:
+*    These functions are only available if LIST_T_OBSERVERS is defined
+*    when both the library and the program are compiled, e.g. with
+*    -DLIST_T_OBSERVERS. Otherwise they are not compiled at all and the
+*    other functions don't have any additional cost.
+*  NOTE:
+*    The index of each event is found walking from the closest end of
+*    the list_t or from the node of the previous event, so that the
+*    events sent by the functions that edit many consecutive items
+*    don't cost more than the functions themselves.
+*    An observer must never edit the list_t it observes. */
+#ifdef LIST_T_OBSERVERS
+
+/* ---------------------------------------------------------------------
+*  ListOperation
+*  ---------------------------------------------------------------------
+*  Description:
+*    The type of an event:
+*    LIST_ADD ---> An item has been added in the given index
+*    LIST_REMOVE ---> The item in the given index is about to be removed
+*    LIST_REPLACE ---> The item in the given index has been replaced,
+*                      swap sends two of these events
+*    LIST_CLEAR ---> All the items are about to be removed
+*    LIST_REORDER ---> The order of the items has changed (e.g. after
+*                      reverse_in_place), the list_t has to be read again */
+typedef enum { LIST_ADD, LIST_REMOVE, LIST_REPLACE, LIST_CLEAR, LIST_REORDER } list_operation;
+
+/* ---------------------------------------------------------------------
+*  Observer
+*  ---------------------------------------------------------------------
+*  Description:
+*    The function called for each event. The index is -1 for LIST_CLEAR
+*    and LIST_REORDER. The old item is NULL for LIST_ADD, the new item
+*    is NULL for LIST_REMOVE, and both are NULL for LIST_CLEAR and
+*    LIST_REORDER. The pointers are only valid inside the function.
+*  Example (assuming T is int):
+*    void log_event(list_t list, list_operation op, int index,
+*        const int* old_item, const int* new_item, void* ctx)
+*    {
+*        if (op == LIST_ADD) printf("%d added in %d\n", *new_item, index);
+*    } */
+typedef void(*list_observer_t)(list_t list, list_operation op, int index,
+	const T* old_item, const T* new_item, void* ctx);
+
+/* ---------------------------------------------------------------------
+*  AddObserver
+*  ---------------------------------------------------------------------
+*  Description:
+*    Registers an observer on the list_t. Returns FALSE if the list_t or
+*    the observer are NULL.
+*  Parameters:
+*    list ---> The target list_t
+*    observer ---> The function to call for each event
+*    ctx ---> The context passed to the observer */
+bool_t add_observer(list_t list, list_observer_t observer, void* ctx);
+
+/* ---------------------------------------------------------------------
+*  RemoveObserver
+*  ---------------------------------------------------------------------
+*  Description:
+*    Removes the observer registered with the same function and context.
+*    Returns FALSE if the list_t is NULL or if there was no such observer.
+*  Parameters:
+*    list ---> The target list_t
+*    observer ---> The function of the observer
+*    ctx ---> The context of the observer */
+bool_t remove_observer(list_t list, list_observer_t observer, void* ctx);
+
+#endif
+
 #endif
 
 /* Copyright (C) 2015 Sergio Pedri and Andrea Salvati
@@ -0,0 +1,724 @@
+/* ============================================================================
+*  list_template.h
+* ============================================================================
+
+*  Author:         (c) 2015 Sergio Pedri and Andrea Salvati
+*  License:        See the end of this file for license information
+*/
+
+#ifndef LIST_TEMPLATE_H
+#define LIST_TEMPLATE_H
+
+#include <stdlib.h>
+#include "list_t.h"
+
+/* =====================================================================
+*  Typed lists
+*  =====================================================================
+*  Description:
+*    Macros that generate a prefixed list_t implementation for a given
+*    element type, so that a single program can use lists of different
+*    types without compiling the library more than once or boxing the
+*    items as void pointers.
+*    The generated functions work on the real element type and use the
+*    given comparator directly: if it is a macro or a static inline
+*    function, comparisons and equality checks are inlined by the
+*    compiler instead of being dispatched through a function pointer.
+*  How-To:
+*    Use DECLARE_LIST inside a header file to declare the types and the
+*    functions, then use DEFINE_LIST inside a single source file.
+*  Example (a list of int and a list of struct point):
+*    #define INT_CMP(a, b) ((a) > (b) ? GREATER : (a) < (b) ? LOWER : EQUAL)
+*    DECLARE_LIST(ilist, int)
+*    DEFINE_LIST(ilist, int, INT_CMP)
+*
+*    static inline comparation point_cmp(struct point a, struct point b)
+*    { ... }
+*    DECLARE_LIST(plist, struct point)
+*    DEFINE_LIST(plist, struct point, point_cmp)
+*
+*    ilist_t numbers = ilist_create();
+*    ilist_add(42, numbers);
+*    ilist_t sorted = ilist_order_by(numbers);
+*  NOTE:
+*    The generated functions follow the same rules and return values
+*    of their list_t counterparts (see the list_t.h file), the only
+*    difference being the name prefix and the element type. */
+
+/* ---------------------------------------------------------------------
+*  DeclareList
+*  ---------------------------------------------------------------------
+*  Description:
+*    Declares the name_t list type and all the name_* functions that
+*    work with it.
+*  Parameters:
+*    name ---> The prefix to use for the new type and its functions
+*    type ---> The type of the elements inside the list */
+#define DECLARE_LIST(name, type)                                              \
+struct name##Elem                                                             \
+{                                                                             \
+	struct name##Elem* previous;                                              \
+	type info;                                                                \
+	struct name##Elem* next;                                                  \
+};                                                                            \
+struct name##Base                                                             \
+{                                                                             \
+	struct name##Elem* head;                                                  \
+	struct name##Elem* tail;                                                  \
+	int length;                                                               \
+	unsigned int sync;                                                        \
+};                                                                            \
+typedef struct name##Base* name##_t;                                          \
+                                                                              \
+/* Generic functions */                                                       \
+name##_t name##_create();                                                     \
+bool_t name##_clear(name##_t list);                                           \
+bool_t name##_destroy(name##_t* list);                                        \
+name##_t name##_copy(const name##_t source);                                  \
+name##_t name##_create_from(type* array, int size);                           \
+type* name##_to_array(name##_t list, int* size);                              \
+bool_t name##_is_empty(name##_t list);                                        \
+int name##_size(name##_t list);                                               \
+bool_t name##_is_element(const type item, name##_t list);                     \
+int name##_index_of(const type item, name##_t list);                          \
+bool_t name##_get_first(name##_t list, type* result);                         \
+bool_t name##_get_last(name##_t list, type* result);                          \
+bool_t name##_get(name##_t list, int index, type* result);                    \
+bool_t name##_add(const type item, name##_t list);                            \
+bool_t name##_add_at(const type item, name##_t list, int index);              \
+bool_t name##_remove_item(const type item, name##_t list);                    \
+bool_t name##_remove_at(name##_t list, int index);                            \
+bool_t name##_replace_at(const type item, name##_t list, int index);          \
+                                                                              \
+/* stack */                                                                   \
+bool_t name##_push(const type item, name##_t stack);                          \
+bool_t name##_pop(name##_t stack, type* result);                              \
+bool_t name##_peek(name##_t stack, type* result);                             \
+                                                                              \
+/* LINQ */                                                                    \
+bool_t name##_first_or_default(name##_t list, type* result,                   \
+                               bool_t(*expression)(type));                    \
+int name##_count(name##_t list, bool_t(*expression)(type));                   \
+name##_t name##_where(name##_t list, bool_t(*expression)(type));              \
+name##_t name##_remove_where(name##_t list, bool_t(*expression)(type));       \
+name##_t name##_derive(name##_t list, type(*expression)(type));               \
+bool_t name##_any(name##_t list, bool_t(*expression)(type));                  \
+bool_t name##_all(name##_t list, bool_t(*expression)(type));                  \
+bool_t name##_for_each(name##_t list, void(*expression)(type));               \
+name##_t name##_reverse(name##_t list);                                       \
+name##_t name##_distinct(name##_t list);                                      \
+bool_t name##_get_min(name##_t list, type* result);                           \
+bool_t name##_get_max(name##_t list, type* result);                           \
+name##_t name##_order_by(name##_t list);                                      \
+name##_t name##_order_by_descending(name##_t list);                           \
+bool_t name##_sequence_equals(name##_t list1, name##_t list2);                \
+                                                                              \
+/* Sorting */                                                                 \
+void name##_introsort(type* vector, int len);
+
+/* ---------------------------------------------------------------------
+*  DefineList
+*  ---------------------------------------------------------------------
+*  Description:
+*    Generates the implementation of all the functions declared by the
+*    DECLARE_LIST macro with the same name and type.
+*  NOTE:
+*    The DECLARE_LIST macro must be visible before this one.
+*  Parameters:
+*    name ---> The prefix used with the DECLARE_LIST macro
+*    type ---> The type of the elements inside the list
+*    cmp ---> Macro or function that takes two items and returns a
+*             comparation value (see the Comparator in list_t.h) */
+#define DEFINE_LIST(name, type, cmp)                                          \
+DEFINE_LIST_GENERIC(name, type, cmp)                                          \
+DEFINE_LIST_STACK(name, type)                                                 \
+DEFINE_LIST_LINQ(name, type, cmp)                                             \
+DEFINE_LIST_INTROSORT(name, type, cmp)
+
+// Internal macros used by DEFINE_LIST, do NOT use them inside your code
+#define LIST_EQUALS(cmp, a, b) (cmp(a, b) == EQUAL)
+
+#define LIST_NEW_NODE(name, node, item)                                       \
+struct name##Elem* node = (struct name##Elem*)malloc(sizeof(struct name##Elem)); \
+node->info = item
+
+#define LIST_LOCATE(list, index, node)                                        \
+if (index <= list->length / 2)                                                \
+{                                                                             \
+	int position = 0;                                                         \
+	node = list->head;                                                        \
+	while (position != index)                                                 \
+	{                                                                         \
+		node = node->next;                                                    \
+		position++;                                                           \
+	}                                                                         \
+}                                                                             \
+else                                                                          \
+{                                                                             \
+	int position = list->length - 1;                                          \
+	node = list->tail;                                                        \
+	while (position != index)                                                 \
+	{                                                                         \
+		node = node->previous;                                                \
+		position--;                                                           \
+	}                                                                         \
+}
+
+#define LIST_UNLINK(list, node)                                               \
+if (node->previous == NULL) list->head = node->next;                          \
+else node->previous->next = node->next;                                       \
+if (node->next == NULL) list->tail = node->previous;                          \
+else node->next->previous = node->previous;                                   \
+free(node);                                                                   \
+list->length--;                                                               \
+list->sync++
+
+#define DEFINE_LIST_GENERIC(name, type, cmp)                                  \
+name##_t name##_create()                                                      \
+{                                                                             \
+	name##_t outList = (name##_t)malloc(sizeof(struct name##Base));           \
+	outList->head = NULL;                                                     \
+	outList->tail = NULL;                                                     \
+	outList->length = 0;                                                      \
+	outList->sync = 0;                                                        \
+	return outList;                                                           \
+}                                                                             \
+                                                                              \
+bool_t name##_clear(name##_t list)                                            \
+{                                                                             \
+	if (list == NULL) return FALSE;                                           \
+	if (list->length == 0) return TRUE;                                       \
+	struct name##Elem* iterator = list->head;                                 \
+	while (iterator != NULL)                                                  \
+	{                                                                         \
+		struct name##Elem* temp = iterator;                                   \
+		iterator = iterator->next;                                            \
+		free(temp);                                                           \
+	}                                                                         \
+	list->head = NULL;                                                        \
+	list->tail = NULL;                                                        \
+	list->length = 0;                                                         \
+	list->sync++;                                                             \
+	return TRUE;                                                              \
+}                                                                             \
+                                                                              \
+bool_t name##_destroy(name##_t* list)                                         \
+{                                                                             \
+	if (!name##_clear(*list)) return FALSE;                                   \
+	free(*list);                                                              \
+	*list = NULL;                                                             \
+	return TRUE;                                                              \
+}                                                                             \
+                                                                              \
+name##_t name##_copy(const name##_t source)                                   \
+{                                                                             \
+	if (source == NULL) return NULL;                                          \
+	name##_t outList = name##_create();                                       \
+	struct name##Elem* iterator = source->head;                               \
+	while (iterator != NULL)                                                  \
+	{                                                                         \
+		name##_add(iterator->info, outList);                                  \
+		iterator = iterator->next;                                            \
+	}                                                                         \
+	return outList;                                                           \
+}                                                                             \
+                                                                              \
+name##_t name##_create_from(type* array, int size)                            \
+{                                                                             \
+	if (array == NULL || size <= 0) return NULL;                              \
+	name##_t outList = name##_create();                                       \
+	int i;                                                                    \
+	for (i = 0; i < size; i++) name##_add(array[i], outList);                 \
+	return outList;                                                           \
+}                                                                             \
+                                                                              \
+type* name##_to_array(name##_t list, int* size)                               \
+{                                                                             \
+	if (list == NULL || list->length == 0)                                    \
+	{                                                                         \
+		*size = -1;                                                           \
+		return NULL;                                                          \
+	}                                                                         \
+	*size = list->length;                                                     \
+	type* array = (type*)malloc(sizeof(type) * (*size));                      \
+	int i = 0;                                                                \
+	struct name##Elem* iterator = list->head;                                 \
+	while (iterator != NULL)                                                  \
+	{                                                                         \
+		array[i++] = iterator->info;                                          \
+		iterator = iterator->next;                                            \
+	}                                                                         \
+	return array;                                                             \
+}                                                                             \
+                                                                              \
+bool_t name##_is_empty(name##_t list)                                         \
+{                                                                             \
+	return list == NULL || list->length == 0;                                 \
+}                                                                             \
+                                                                              \
+int name##_size(name##_t list)                                                \
+{                                                                             \
+	return list == NULL ? -1 : list->length;                                  \
+}                                                                             \
+                                                                              \
+int name##_index_of(const type item, name##_t list)                           \
+{                                                                             \
+	if (name##_is_empty(list)) return -1;                                     \
+	int index = 0;                                                            \
+	struct name##Elem* iterator = list->head;                                 \
+	while (iterator != NULL)                                                  \
+	{                                                                         \
+		if (LIST_EQUALS(cmp, iterator->info, item)) return index;             \
+		iterator = iterator->next;                                            \
+		index++;                                                              \
+	}                                                                         \
+	return -1;                                                                \
+}                                                                             \
+                                                                              \
+bool_t name##_is_element(const type item, name##_t list)                      \
+{                                                                             \
+	return name##_index_of(item, list) != -1;                                 \
+}                                                                             \
+                                                                              \
+bool_t name##_get_first(name##_t list, type* result)                          \
+{                                                                             \
+	if (name##_is_empty(list)) return FALSE;                                  \
+	*result = list->head->info;                                               \
+	return TRUE;                                                              \
+}                                                                             \
+                                                                              \
+bool_t name##_get_last(name##_t list, type* result)                           \
+{                                                                             \
+	if (name##_is_empty(list)) return FALSE;                                  \
+	*result = list->tail->info;                                               \
+	return TRUE;                                                              \
+}                                                                             \
+                                                                              \
+bool_t name##_get(name##_t list, int index, type* result)                     \
+{                                                                             \
+	if (list == NULL || index < 0 || index >= list->length) return FALSE;     \
+	struct name##Elem* node;                                                  \
+	LIST_LOCATE(list, index, node);                                           \
+	*result = node->info;                                                     \
+	return TRUE;                                                              \
+}                                                                             \
+                                                                              \
+bool_t name##_add(const type item, name##_t list)                             \
+{                                                                             \
+	if (list == NULL) return FALSE;                                           \
+	LIST_NEW_NODE(name, newNode, item);                                       \
+	newNode->next = NULL;                                                     \
+	newNode->previous = list->tail;                                           \
+	if (list->length == 0) list->head = newNode;                              \
+	else list->tail->next = newNode;                                          \
+	list->tail = newNode;                                                     \
+	list->length++;                                                           \
+	list->sync++;                                                             \
+	return TRUE;                                                              \
+}                                                                             \
+                                                                              \
+bool_t name##_add_at(const type item, name##_t list, int index)               \
+{                                                                             \
+	if (name##_is_empty(list) || index < 0 || index >= list->length)          \
+	{                                                                         \
+		return FALSE;                                                         \
+	}                                                                         \
+	if (index == 0) return name##_push(item, list);                           \
+	struct name##Elem* target;                                                \
+	LIST_LOCATE(list, index, target);                                         \
+	LIST_NEW_NODE(name, newNode, item);                                       \
+	newNode->previous = target->previous;                                     \
+	newNode->previous->next = newNode;                                        \
+	newNode->next = target;                                                   \
+	target->previous = newNode;                                               \
+	list->length++;                                                           \
+	list->sync++;                                                             \
+	return TRUE;                                                              \
+}                                                                             \
+                                                                              \
+bool_t name##_remove_item(const type item, name##_t list)                     \
+{                                                                             \
+	if (name##_is_empty(list)) return FALSE;                                  \
+	struct name##Elem* iterator = list->head;                                 \
+	while (iterator != NULL)                                                  \
+	{                                                                         \
+		if (LIST_EQUALS(cmp, iterator->info, item))                           \
+		{                                                                     \
+			LIST_UNLINK(list, iterator);                                      \
+			return TRUE;                                                      \
+		}                                                                     \
+		iterator = iterator->next;                                            \
+	}                                                                         \
+	return FALSE;                                                             \
+}                                                                             \
+                                                                              \
+bool_t name##_remove_at(name##_t list, int index)                             \
+{                                                                             \
+	if (name##_is_empty(list) || index < 0 || index >= list->length)          \
+	{                                                                         \
+		return FALSE;                                                         \
+	}                                                                         \
+	struct name##Elem* target;                                                \
+	LIST_LOCATE(list, index, target);                                         \
+	LIST_UNLINK(list, target);                                                \
+	return TRUE;                                                              \
+}                                                                             \
+                                                                              \
+bool_t name##_replace_at(const type item, name##_t list, int index)           \
+{                                                                             \
+	if (list == NULL || index < 0 || index >= list->length) return FALSE;     \
+	struct name##Elem* target;                                                \
+	LIST_LOCATE(list, index, target);                                         \
+	target->info = item;                                                      \
+	list->sync++;                                                             \
+	return TRUE;                                                              \
+}
+
+#define DEFINE_LIST_STACK(name, type)                                         \
+bool_t name##_push(const type item, name##_t stack)                           \
+{                                                                             \
+	if (stack == NULL) return FALSE;                                          \
+	if (stack->length == 0) return name##_add(item, stack);                   \
+	LIST_NEW_NODE(name, newNode, item);                                       \
+	newNode->previous = NULL;                                                 \
+	newNode->next = stack->head;                                              \
+	stack->head->previous = newNode;                                          \
+	stack->head = newNode;                                                    \
+	stack->length++;                                                          \
+	stack->sync++;                                                            \
+	return TRUE;                                                              \
+}                                                                             \
+                                                                              \
+bool_t name##_pop(name##_t stack, type* result)                               \
+{                                                                             \
+	if (name##_is_empty(stack)) return FALSE;                                 \
+	struct name##Elem* top = stack->head;                                     \
+	*result = top->info;                                                      \
+	LIST_UNLINK(stack, top);                                                  \
+	return TRUE;                                                              \
+}                                                                             \
+                                                                              \
+bool_t name##_peek(name##_t stack, type* result)                              \
+{                                                                             \
+	return name##_get_first(stack, result);                                   \
+}
+
+#define DEFINE_LIST_LINQ(name, type, cmp)                                     \
+bool_t name##_first_or_default(name##_t list, type* result,                   \
+                               bool_t(*expression)(type))                     \
+{                                                                             \
+	if (name##_is_empty(list)) return FALSE;                                  \
+	struct name##Elem* iterator = list->head;                                 \
+	while (iterator != NULL)                                                  \
+	{                                                                         \
+		if (expression(iterator->info))                                       \
+		{                                                                     \
+			*result = iterator->info;                                         \
+			return TRUE;                                                      \
+		}                                                                     \
+		iterator = iterator->next;                                            \
+	}                                                                         \
+	return FALSE;                                                             \
+}                                                                             \
+                                                                              \
+int name##_count(name##_t list, bool_t(*expression)(type))                    \
+{                                                                             \
+	if (name##_is_empty(list)) return -1;                                     \
+	int total = 0;                                                            \
+	struct name##Elem* iterator = list->head;                                 \
+	while (iterator != NULL)                                                  \
+	{                                                                         \
+		if (expression(iterator->info)) total++;                              \
+		iterator = iterator->next;                                            \
+	}                                                                         \
+	return total;                                                             \
+}                                                                             \
+                                                                              \
+name##_t name##_where(name##_t list, bool_t(*expression)(type))               \
+{                                                                             \
+	if (name##_is_empty(list)) return NULL;                                   \
+	name##_t outList = name##_create();                                       \
+	struct name##Elem* iterator = list->head;                                 \
+	while (iterator != NULL)                                                  \
+	{                                                                         \
+		if (expression(iterator->info)) name##_add(iterator->info, outList);  \
+		iterator = iterator->next;                                            \
+	}                                                                         \
+	return outList;                                                           \
+}                                                                             \
+                                                                              \
+name##_t name##_remove_where(name##_t list, bool_t(*expression)(type))        \
+{                                                                             \
+	if (name##_is_empty(list)) return NULL;                                   \
+	name##_t outList = name##_create();                                       \
+	struct name##Elem* iterator = list->head;                                 \
+	while (iterator != NULL)                                                  \
+	{                                                                         \
+		if (!expression(iterator->info)) name##_add(iterator->info, outList); \
+		iterator = iterator->next;                                            \
+	}                                                                         \
+	return outList;                                                           \
+}                                                                             \
+                                                                              \
+name##_t name##_derive(name##_t list, type(*expression)(type))                \
+{                                                                             \
+	if (name##_is_empty(list)) return NULL;                                   \
+	name##_t outList = name##_create();                                       \
+	struct name##Elem* iterator = list->head;                                 \
+	while (iterator != NULL)                                                  \
+	{                                                                         \
+		name##_add(expression(iterator->info), outList);                      \
+		iterator = iterator->next;                                            \
+	}                                                                         \
+	return outList;                                                           \
+}                                                                             \
+                                                                              \
+bool_t name##_any(name##_t list, bool_t(*expression)(type))                   \
+{                                                                             \
+	if (name##_is_empty(list)) return FALSE;                                  \
+	struct name##Elem* iterator = list->head;                                 \
+	while (iterator != NULL)                                                  \
+	{                                                                         \
+		if (expression(iterator->info)) return TRUE;                          \
+		iterator = iterator->next;                                            \
+	}                                                                         \
+	return FALSE;                                                             \
+}                                                                             \
+                                                                              \
+bool_t name##_all(name##_t list, bool_t(*expression)(type))                   \
+{                                                                             \
+	if (name##_is_empty(list)) return FALSE;                                  \
+	struct name##Elem* iterator = list->head;                                 \
+	while (iterator != NULL)                                                  \
+	{                                                                         \
+		if (!expression(iterator->info)) return FALSE;                        \
+		iterator = iterator->next;                                            \
+	}                                                                         \
+	return TRUE;                                                              \
+}                                                                             \
+                                                                              \
+bool_t name##_for_each(name##_t list, void(*expression)(type))                \
+{                                                                             \
+	if (name##_is_empty(list)) return FALSE;                                  \
+	struct name##Elem* iterator = list->head;                                 \
+	while (iterator != NULL)                                                  \
+	{                                                                         \
+		expression(iterator->info);                                           \
+		iterator = iterator->next;                                            \
+	}                                                                         \
+	return TRUE;                                                              \
+}                                                                             \
+                                                                              \
+name##_t name##_reverse(name##_t list)                                        \
+{                                                                             \
+	if (name##_is_empty(list)) return NULL;                                   \
+	name##_t outList = name##_create();                                       \
+	struct name##Elem* iterator = list->head;                                 \
+	while (iterator != NULL)                                                  \
+	{                                                                         \
+		name##_push(iterator->info, outList);                                 \
+		iterator = iterator->next;                                            \
+	}                                                                         \
+	return outList;                                                           \
+}                                                                             \
+                                                                              \
+name##_t name##_distinct(name##_t list)                                       \
+{                                                                             \
+	if (name##_is_empty(list)) return NULL;                                   \
+	name##_t outList = name##_create();                                       \
+	struct name##Elem* iterator = list->head;                                 \
+	while (iterator != NULL)                                                  \
+	{                                                                         \
+		if (!name##_is_element(iterator->info, outList))                      \
+		{                                                                     \
+			name##_add(iterator->info, outList);                              \
+		}                                                                     \
+		iterator = iterator->next;                                            \
+	}                                                                         \
+	return outList;                                                           \
+}                                                                             \
+                                                                              \
+bool_t name##_get_min(name##_t list, type* result)                            \
+{                                                                             \
+	if (name##_is_empty(list)) return FALSE;                                  \
+	struct name##Elem* iterator = list->head;                                 \
+	*result = iterator->info;                                                 \
+	for (iterator = iterator->next; iterator != NULL; iterator = iterator->next) \
+	{                                                                         \
+		if (cmp(*result, iterator->info) == GREATER) *result = iterator->info; \
+	}                                                                         \
+	return TRUE;                                                              \
+}                                                                             \
+                                                                              \
+bool_t name##_get_max(name##_t list, type* result)                            \
+{                                                                             \
+	if (name##_is_empty(list)) return FALSE;                                  \
+	struct name##Elem* iterator = list->head;                                 \
+	*result = iterator->info;                                                 \
+	for (iterator = iterator->next; iterator != NULL; iterator = iterator->next) \
+	{                                                                         \
+		if (cmp(*result, iterator->info) == LOWER) *result = iterator->info;  \
+	}                                                                         \
+	return TRUE;                                                              \
+}                                                                             \
+                                                                              \
+name##_t name##_order_by(name##_t list)                                       \
+{                                                                             \
+	if (name##_is_empty(list)) return NULL;                                   \
+	int len;                                                                  \
+	type* temp_vector = name##_to_array(list, &len);                          \
+	name##_introsort(temp_vector, len);                                       \
+	name##_t outList = name##_create_from(temp_vector, len);                  \
+	free(temp_vector);                                                        \
+	return outList;                                                           \
+}                                                                             \
+                                                                              \
+name##_t name##_order_by_descending(name##_t list)                            \
+{                                                                             \
+	if (name##_is_empty(list)) return NULL;                                   \
+	int len, i;                                                               \
+	type* temp_vector = name##_to_array(list, &len);                          \
+	name##_introsort(temp_vector, len);                                       \
+	name##_t outList = name##_create();                                       \
+	for (i = 0; i < len; i++) name##_push(temp_vector[i], outList);           \
+	free(temp_vector);                                                        \
+	return outList;                                                           \
+}                                                                             \
+                                                                              \
+bool_t name##_sequence_equals(name##_t list1, name##_t list2)                 \
+{                                                                             \
+	if (list1 == NULL || list2 == NULL) return list1 == NULL && list2 == NULL; \
+	if (list1->length != list2->length) return FALSE;                         \
+	struct name##Elem* iterator1 = list1->head;                               \
+	struct name##Elem* iterator2 = list2->head;                               \
+	while (iterator1 != NULL)                                                 \
+	{                                                                         \
+		if (!LIST_EQUALS(cmp, iterator1->info, iterator2->info)) return FALSE; \
+		iterator1 = iterator1->next;                                          \
+		iterator2 = iterator2->next;                                          \
+	}                                                                         \
+	return TRUE;                                                              \
+}
+
+/* The generated introsort mirrors the one inside the Introsort folder,
+*  with the comparator expanded in place of the function pointer. */
+#define DEFINE_LIST_INTROSORT(name, type, cmp)                                \
+static inline void name##_swap_items(type* n1, type* n2)                      \
+{                                                                             \
+	type temp = *n1;                                                          \
+	*n1 = *n2;                                                                \
+	*n2 = temp;                                                               \
+}                                                                             \
+                                                                              \
+static void name##_sift_down(type* vector, int start, int end)                \
+{                                                                             \
+	int root = start, child;                                                  \
+	while ((child = (root << 1) + 1) <= end)                                  \
+	{                                                                         \
+		int swap = root;                                                      \
+		if (cmp(vector[swap], vector[child]) == LOWER) swap = child;          \
+		if (child + 1 <= end && cmp(vector[swap], vector[child + 1]) == LOWER) \
+		{                                                                     \
+			swap = child + 1;                                                 \
+		}                                                                     \
+		if (swap == root) return;                                             \
+		name##_swap_items(vector + root, vector + swap);                      \
+		root = swap;                                                          \
+	}                                                                         \
+}                                                                             \
+                                                                              \
+static void name##_heapsort(type* vector, int n)                              \
+{                                                                             \
+	int start = (n - 2) / 2, end = n - 1;                                     \
+	for (; start >= 0; start--) name##_sift_down(vector, start, n - 1);       \
+	while (end > 0)                                                           \
+	{                                                                         \
+		name##_swap_items(vector + end, vector);                              \
+		end--;                                                                \
+		name##_sift_down(vector, 0, end);                                     \
+	}                                                                         \
+}                                                                             \
+                                                                              \
+static void name##_insertion_sort(type* vector, int size)                     \
+{                                                                             \
+	int i, j;                                                                 \
+	for (i = 1; i < size; i++)                                                \
+	{                                                                         \
+		type item = vector[i];                                                \
+		for (j = i; j > 0 && cmp(item, vector[j - 1]) == LOWER; j--)          \
+		{                                                                     \
+			vector[j] = vector[j - 1];                                        \
+		}                                                                     \
+		vector[j] = item;                                                     \
+	}                                                                         \
+}                                                                             \
+                                                                              \
+static int name##_partition(type* vector, int left, int right)                \
+{                                                                             \
+	int pivot_index = left + (rand() % (right - left + 1));                   \
+	type pivot = vector[pivot_index];                                         \
+	name##_swap_items(vector + pivot_index, vector + right);                  \
+	int i = left - 1, j;                                                      \
+	for (j = left; j < right; j++)                                            \
+	{                                                                         \
+		if (cmp(vector[j], pivot) != GREATER)                                 \
+		{                                                                     \
+			i++;                                                              \
+			name##_swap_items(vector + i, vector + j);                        \
+		}                                                                     \
+	}                                                                         \
+	name##_swap_items(vector + i + 1, vector + right);                        \
+	return i + 1;                                                             \
+}                                                                             \
+                                                                              \
+static void name##_main_sort(type* vector, int left, int right, int depth)    \
+{                                                                             \
+	while (left < right)                                                      \
+	{                                                                         \
+		int len = right - left + 1;                                           \
+		if (depth == 0)                                                       \
+		{                                                                     \
+			name##_heapsort(vector + left, len);                              \
+			return;                                                           \
+		}                                                                     \
+		if (len < 9)                                                          \
+		{                                                                     \
+			name##_insertion_sort(vector + left, len);                        \
+			return;                                                           \
+		}                                                                     \
+		int part = name##_partition(vector, left, right);                     \
+		depth--;                                                              \
+		name##_main_sort(vector, left, part - 1, depth);                      \
+		left = part + 1;                                                      \
+	}                                                                         \
+}                                                                             \
+                                                                              \
+void name##_introsort(type* vector, int len)                                  \
+{                                                                             \
+	if (vector == NULL || len <= 0) return;                                   \
+	int maxdepth = 0, value = len;                                            \
+	while (value)                                                             \
+	{                                                                         \
+		maxdepth++;                                                           \
+		value /= 10;                                                          \
+	}                                                                         \
+	name##_main_sort(vector, 0, len - 1, maxdepth * 2);                       \
+}
+
+#endif
+
+/* Copyright (C) 2015 Sergio Pedri and Andrea Salvati
+
+* This library is free software; you can redistribute it and/or
+* modify it under the terms of the GNU Lesser General Public
+* License as published by the Free Software Foundation; either
+* version 2.1 of the License, or (at your option) any later version.
+
+* This library is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+* Lesser General Public License for more details.
+
+* You should have received a copy of the GNU Lesser General Public
+* License along with this library; If not, see http://www.gnu.org/licenses/
+*/
@@ -0,0 +1,752 @@
+/* ============================================================================
+*  benchmark.c
+* ============================================================================
+
+*  Author:         (c) 2015 Sergio Pedri
+*  License:        See the end of this file for license information
+
+*  NOTE:
+*    This program measures the performances of the library functions with
+*    lists of different lengths (from 10^2 to 10^7 items) and with
+*    different distributions of their items. Each benchmark is repeated
+*    a number of times, and the median, the 99th percentile and the
+*    minimum time per operation are reported in nanoseconds, as a table,
+*    as CSV or as JSON, so that the results can be compared over time.
+*    Usage: benchmark [--csv | --json] [--max LENGTH] [--filter TEXT]
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <limits.h>
+#include <time.h>
+#include "Library\list_t.h"
+
+/* ============= Settings ============= */
+
+// Minimum and maximum number of samples for each benchmark
+#define MIN_SAMPLES 3
+#define MAX_SAMPLES 100
+
+// Total time after which a benchmark stops collecting samples, in nanoseconds
+#define TARGET_TIME 200000000LL
+
+// Number of operations performed by the benchmarks that access random indexes
+#define INDEX_OPERATIONS 256
+
+// Length limits for the benchmarks with a O(n) cost per operation or a O(n^2) total cost
+#define LINEAR_LIMIT 1000000
+#define QUADRATIC_LIMIT 10000
+
+// Default and absolute maximum length of the lists
+#define DEFAULT_MAX_LENGTH 1000000
+#define MAX_LENGTH 10000000
+
+/* ============= Types ============= */
+
+// Runs an operation on the list_t created from the data and returns the number of operations performed
+typedef long long(*benchmark_function)(list_t list, const T* data, int len);
+
+// The structures that can be attached to the list_t of a benchmark
+#define ATTACH_INDEX 1
+#define ATTACH_FILTER 2
+#define ATTACH_AGGREGATE 4
+#define ATTACH_RANGES 8
+#define ATTACH_VIEW 16
+#define ATTACH_ALL (ATTACH_INDEX | ATTACH_FILTER | ATTACH_AGGREGATE | ATTACH_RANGES | ATTACH_VIEW)
+
+// A single benchmark: edits is TRUE if a new list_t is needed for each sample,
+// attachments are added to each list_t before the measured calls
+typedef struct
+{
+	const char* group;
+	const char* name;
+	benchmark_function function;
+	int limit;
+	bool_t edits;
+	int attachments;
+} benchmarkCase;
+
+// A distribution of the items inside the benchmark lists
+typedef struct
+{
+	const char* name;
+	void(*fill)(T* data, int len);
+} distribution;
+
+// The output format of the results
+typedef enum { FORMAT_TEXT, FORMAT_CSV, FORMAT_JSON } outputFormat;
+
+// Accumulates the results of the benchmarks, so that the compiler can't remove the calls
+static volatile long long sink;
+
+// The aggregate and the view attached to the current list_t, if any
+static list_aggregate_t attachedAggregate;
+static list_view_t attachedView;
+
+// The current data written as text, one item per line, and a scratch file for list_write
+static char* text;
+static int textLength;
+static FILE* scratch;
+
+/* ============= Random numbers ============= */
+
+// State of the xorshift generator, reset before each benchmark to get the same data every time
+static unsigned int randomState;
+
+// Returns a random number between 0 and max - 1
+static inline int random_below(int max)
+{
+	randomState ^= randomState << 13;
+	randomState ^= randomState >> 17;
+	randomState ^= randomState << 5;
+	return (int)(randomState % (unsigned int)max);
+}
+
+/* ============= Distributions ============= */
+
+static void fill_random(T* data, int len)
+{
+	int i;
+	for (i = 0; i < len; i++) data[i] = random_below(2 * len + 1) - len;
+}
+
+static void fill_sorted(T* data, int len)
+{
+	int i;
+	for (i = 0; i < len; i++) data[i] = i;
+}
+
+static void fill_reversed(T* data, int len)
+{
+	int i;
+	for (i = 0; i < len; i++) data[i] = len - i;
+}
+
+static void fill_duplicates(T* data, int len)
+{
+	int i;
+	for (i = 0; i < len; i++) data[i] = random_below(16);
+}
+
+static const distribution distributions[] =
+{
+	{ "random", fill_random },
+	{ "sorted", fill_sorted },
+	{ "reversed", fill_reversed },
+	{ "duplicates", fill_duplicates }
+};
+
+/* ============= Expressions ============= */
+
+static bool_t is_positive(T item)
+{
+	return item > 0;
+}
+
+static bool_t is_never(T item)
+{
+	(void)item;
+	return FALSE;
+}
+
+static bool_t is_always(T item)
+{
+	(void)item;
+	return TRUE;
+}
+
+static bool_t greater_than_ctx(T item, void* ctx)
+{
+	return item > *(int*)ctx;
+}
+
+static bool_t are_equal(T item1, T item2)
+{
+	return item1 == item2;
+}
+
+static bool_t are_equal_ctx(T item1, T item2, void* ctx)
+{
+	(void)ctx;
+	return item1 == item2;
+}
+
+static comparation compare(T item1, T item2)
+{
+	return item1 > item2 ? GREATER : item1 == item2 ? EQUAL : LOWER;
+}
+
+static comparation compare_ctx(T item1, T item2, void* ctx)
+{
+	(void)ctx;
+	return item1 > item2 ? GREATER : item1 == item2 ? EQUAL : LOWER;
+}
+
+static T twice(T item)
+{
+	return item * 2;
+}
+
+static T add_ctx(T item, void* ctx)
+{
+	return item + *(int*)ctx;
+}
+
+static T add_items(T item1, T item2)
+{
+	return item1 + item2;
+}
+
+// Small numeric key, so that the sum of 10^7 items doesn't overflow
+static int small_key(T item)
+{
+	return item & 127;
+}
+
+static void accumulate(T item)
+{
+	sink += item;
+}
+
+static void accumulate_ctx(T item, void* ctx)
+{
+	*(long long*)ctx += item;
+}
+
+// Multiplicative hash for the hash index and the Bloom filter
+static unsigned int hash(T item)
+{
+	return (unsigned int)item * 2654435761u;
+}
+
+static void positive_batch(const T* items, int len, bool_t* results)
+{
+	int i;
+	for (i = 0; i < len; i++) results[i] = items[i] > 0;
+}
+
+// Deallocates a list_t returned by a function, after using its length
+static inline void discard(list_t result)
+{
+	if (result == NULL) return;
+	sink += size(result);
+	destroy(&result);
+}
+
+/* ============= Attachments ============= */
+
+// Creates a list_t with the given data and attachments
+static list_t create_attached(const T* data, int len, int attachments)
+{
+	list_t list = create_from((T*)data, len);
+	if (attachments & ATTACH_INDEX) enable_hash_index(list, hash);
+	if (attachments & ATTACH_FILTER) enable_bloom_filter(list, hash, len, 0.01f);
+	if (attachments & ATTACH_AGGREGATE) attachedAggregate = register_aggregate(list, small_key);
+	if (attachments & ATTACH_RANGES) enable_range_queries(list, small_key);
+	if (attachments & ATTACH_VIEW) attachedView = create_view(list, is_positive, twice);
+	return list;
+}
+
+// Destroys a list_t created by create_attached, the aggregate is deallocated with it
+static void destroy_attached(list_t* list)
+{
+	if (attachedView != NULL) destroy_view(&attachedView);
+	attachedAggregate = NULL;
+	destroy(list);
+}
+
+// Writes the data as text, so that the parsing benchmarks don't measure it
+static void build_text(const T* data, int len)
+{
+	list_t list = create_from((T*)data, len);
+	textLength = list_sprint(NULL, 0, list, "%d", "\n");
+	text = (char*)realloc(text, textLength + 1);
+	list_sprint(text, textLength + 1, list, "%d", "\n");
+	destroy(&list);
+}
+
+/* ============= Benchmarks ============= */
+
+// Declares a benchmark that performs a single call that processes all the items of the list_t
+#define LINEAR_BENCHMARK(name, call)                                  \
+static long long bench_##name(list_t list, const T* data, int len)    \
+{                                                                     \
+	(void)list;                                                       \
+	(void)data;                                                       \
+	call;                                                             \
+	return len;                                                       \
+}
+
+// Declares a benchmark that repeats an operation at random indexes of the list_t
+#define INDEX_BENCHMARK(name, call)                                   \
+static long long bench_##name(list_t list, const T* data, int len)    \
+{                                                                     \
+	int operations = len < INDEX_OPERATIONS ? len : INDEX_OPERATIONS; \
+	int i, index;                                                     \
+	(void)data;                                                       \
+	for (i = 0; i < operations; i++)                                  \
+	{                                                                 \
+		index = random_below(size(list));                             \
+		call;                                                         \
+	}                                                                 \
+	return operations;                                                \
+}
+
+// Declares a benchmark that repeats an operation that doesn't depend on an index
+#define REPEATED_BENCHMARK(name, call)                                \
+static long long bench_##name(list_t list, const T* data, int len)    \
+{                                                                     \
+	int i;                                                            \
+	(void)list;                                                       \
+	(void)data;                                                       \
+	(void)len;                                                        \
+	for (i = 0; i < INDEX_OPERATIONS; i++) call;                      \
+	return INDEX_OPERATIONS;                                          \
+}
+
+// Generic functions
+LINEAR_BENCHMARK(add, { int i; for (i = 0; i < len; i++) add(data[i], list); })
+LINEAR_BENCHMARK(add_range, add_range(list, data, len))
+LINEAR_BENCHMARK(copy, discard(copy(list)))
+LINEAR_BENCHMARK(to_array, { int count; free(to_array(list, &count)); })
+LINEAR_BENCHMARK(clear, clear(list))
+REPEATED_BENCHMARK(get_first, { T item; get_first(list, &item); sink += item; })
+REPEATED_BENCHMARK(get_last, { T item; get_last(list, &item); sink += item; })
+INDEX_BENCHMARK(get, { T item; get(list, index, &item); sink += item; })
+INDEX_BENCHMARK(add_at, add_at(data[index % len], list, index))
+INDEX_BENCHMARK(remove_at, remove_at(list, index))
+INDEX_BENCHMARK(replace_at, replace_at(0, list, index))
+INDEX_BENCHMARK(swap, swap(list, index, random_below(len)))
+INDEX_BENCHMARK(index_of, sink += index_of(data[index], list))
+INDEX_BENCHMARK(last_index_of, sink += last_index_of(data[index], list))
+INDEX_BENCHMARK(is_element, sink += is_element(data[index], list))
+INDEX_BENCHMARK(is_element_missing, sink += is_element(len + 1 + index, list))
+INDEX_BENCHMARK(remove_item, remove_item(data[index], list))
+
+// LINQ functions
+LINEAR_BENCHMARK(where, discard(where(list, is_positive)))
+LINEAR_BENCHMARK(count, sink += count(list, is_positive))
+LINEAR_BENCHMARK(count_ctx, { int threshold = 0; sink += count_ctx(list, greater_than_ctx, &threshold); })
+LINEAR_BENCHMARK(count_lambda, { int threshold = 0; sink += count(list, selector(item, { return item > threshold; })); })
+LINEAR_BENCHMARK(count_batch, sink += count_batch(list, positive_batch))
+LINEAR_BENCHMARK(any, sink += any(list, is_never))
+LINEAR_BENCHMARK(all, sink += all(list, is_always))
+LINEAR_BENCHMARK(any_ctx, { int threshold = INT_MAX; sink += any_ctx(list, greater_than_ctx, &threshold); })
+LINEAR_BENCHMARK(all_ctx, { int threshold = INT_MIN; sink += all_ctx(list, greater_than_ctx, &threshold); })
+LINEAR_BENCHMARK(single, { T item; sink += single(list, &item, is_never); })
+LINEAR_BENCHMARK(first_or_default, { T item; sink += first_or_default(list, &item, is_never); })
+LINEAR_BENCHMARK(first_or_default_ctx, { T item; int threshold = INT_MAX; sink += first_or_default_ctx(list, &item, greater_than_ctx, &threshold); })
+LINEAR_BENCHMARK(last_or_default, { T item; sink += last_or_default(list, &item, is_never); })
+LINEAR_BENCHMARK(first_index_where, sink += first_index_where(list, is_never))
+LINEAR_BENCHMARK(last_index_where, sink += last_index_where(list, is_never))
+LINEAR_BENCHMARK(take_while, discard(take_while(list, is_always)))
+LINEAR_BENCHMARK(take_range, discard(take_range(list, 0, len - 1)))
+LINEAR_BENCHMARK(take_range_into, { list_t target = create(); take_range_into(target, list, 0, len - 1); discard(target); })
+LINEAR_BENCHMARK(skip, discard(skip(list, len / 2)))
+LINEAR_BENCHMARK(skip_while, discard(skip_while(list, is_never)))
+LINEAR_BENCHMARK(trim, discard(trim(list, len / 2)))
+LINEAR_BENCHMARK(concat, discard(concat(list, list)))
+LINEAR_BENCHMARK(zip, discard(zip(list, list, add_items)))
+LINEAR_BENCHMARK(for_each, for_each(list, accumulate))
+LINEAR_BENCHMARK(for_each_ctx, { long long total = 0; for_each_ctx(list, accumulate_ctx, &total); sink += total; })
+LINEAR_BENCHMARK(inverse_for_each, inverse_for_each(list, accumulate))
+LINEAR_BENCHMARK(reverse, discard(reverse(list)))
+LINEAR_BENCHMARK(reverse_range, discard(reverse_range(list, len / 4, len - len / 4 - 1)))
+LINEAR_BENCHMARK(sum, sink += sum(list, small_key))
+LINEAR_BENCHMARK(average, sink += average(list, small_key))
+LINEAR_BENCHMARK(get_numeric_min, sink += get_numeric_min(list, small_key))
+LINEAR_BENCHMARK(get_numeric_max, sink += get_numeric_max(list, small_key))
+LINEAR_BENCHMARK(get_min, { T item; sink += get_min(list, &item, compare); })
+LINEAR_BENCHMARK(get_max, { T item; sink += get_max(list, &item, compare); })
+LINEAR_BENCHMARK(where_ctx, { int threshold = 0; discard(where_ctx(list, greater_than_ctx, &threshold)); })
+LINEAR_BENCHMARK(remove_where, discard(remove_where(list, is_positive)))
+LINEAR_BENCHMARK(remove_where_ctx, { int threshold = 0; discard(remove_where_ctx(list, greater_than_ctx, &threshold)); })
+LINEAR_BENCHMARK(replace_where, discard(replace_where(list, 0, is_positive)))
+LINEAR_BENCHMARK(derive, discard(derive(list, twice)))
+LINEAR_BENCHMARK(derive_ctx, { int offset = 1; discard(derive_ctx(list, add_ctx, &offset)); })
+LINEAR_BENCHMARK(sequence_equals, sink += sequence_equals(list, list, are_equal))
+LINEAR_BENCHMARK(where_batch, discard(where_batch(list, positive_batch)))
+LINEAR_BENCHMARK(remove_where_batch, discard(remove_where_batch(list, positive_batch)))
+LINEAR_BENCHMARK(replace_where_batch, discard(replace_where_batch(list, 0, positive_batch)))
+LINEAR_BENCHMARK(filter_in_place, sink += filter_in_place(list, is_positive))
+LINEAR_BENCHMARK(remove_where_in_place, sink += remove_where_in_place(list, is_positive))
+LINEAR_BENCHMARK(replace_where_in_place, sink += replace_where_in_place(list, 0, is_positive))
+LINEAR_BENCHMARK(derive_in_place, derive_in_place(list, twice))
+LINEAR_BENCHMARK(reverse_in_place, reverse_in_place(list))
+LINEAR_BENCHMARK(where_into, { list_t target = create(); where_into(target, list, is_positive); discard(target); })
+LINEAR_BENCHMARK(derive_into, { list_t target = create(); derive_into(target, list, twice); discard(target); })
+LINEAR_BENCHMARK(distinct, discard(distinct(list, are_equal)))
+LINEAR_BENCHMARK(distinct_ctx, discard(distinct_ctx(list, are_equal_ctx, NULL)))
+LINEAR_BENCHMARK(count_distinct, sink += count_distinct(list, are_equal))
+LINEAR_BENCHMARK(join, discard(join(list, list, are_equal)))
+LINEAR_BENCHMARK(join_where, discard(join_where(list, list, is_positive, are_equal)))
+LINEAR_BENCHMARK(intersect, discard(intersect(list, list, are_equal)))
+LINEAR_BENCHMARK(except, discard(except(list, list, are_equal)))
+
+// Iterators
+LINEAR_BENCHMARK(iterator_next,
+{
+	list_iterator_t iterator = get_iterator(list);
+	T item;
+	while (next(iterator, &item)) sink += item;
+	destroy_iterator(&iterator);
+})
+LINEAR_BENCHMARK(next_batch,
+{
+	list_iterator_t iterator = get_iterator(list);
+	T buffer[256];
+	int read;
+	while ((read = next_batch(iterator, buffer, 256)) > 0) sink += buffer[read - 1];
+	destroy_iterator(&iterator);
+})
+LINEAR_BENCHMARK(next_span,
+{
+	list_span_iterator_t iterator = get_span_iterator(list, NULL, 1024);
+	const T* span;
+	int read;
+	while (next_span(iterator, &span, &read)) sink += span[read - 1];
+	destroy_span_iterator(&iterator);
+})
+LINEAR_BENCHMARK(iterator_remove,
+{
+	list_iterator_t iterator = get_iterator(list);
+	while (move_next(iterator)) iterator_remove(iterator);
+	destroy_iterator(&iterator);
+})
+
+// Stack functions
+LINEAR_BENCHMARK(push, { int i; for (i = 0; i < len; i++) push(data[i], list); })
+LINEAR_BENCHMARK(pop, { T item; while (pop(list, &item)) sink += item; })
+REPEATED_BENCHMARK(peek, { T item; peek(list, &item); sink += item; })
+
+// Sorting functions
+LINEAR_BENCHMARK(order_by, discard(order_by(list, compare)))
+LINEAR_BENCHMARK(order_by_descending, discard(order_by_descending(list, compare)))
+LINEAR_BENCHMARK(order_by_ctx, discard(order_by_ctx(list, compare_ctx, NULL)))
+LINEAR_BENCHMARK(order_by_descending_ctx, discard(order_by_descending_ctx(list, compare_ctx, NULL)))
+LINEAR_BENCHMARK(order_by_into, { list_t target = create(); order_by_into(target, list, compare); discard(target); })
+LINEAR_BENCHMARK(in_place_order_by, discard(in_place_order_by(list, compare)))
+
+// Aggregates and range queries, the first query after an edit rebuilds the segment tree
+REPEATED_BENCHMARK(aggregate_sum, sink += aggregate_sum(attachedAggregate))
+REPEATED_BENCHMARK(aggregate_min, sink += aggregate_min(attachedAggregate))
+REPEATED_BENCHMARK(aggregate_max, sink += aggregate_max(attachedAggregate))
+INDEX_BENCHMARK(aggregate_min_remove, { remove_at(list, index); sink += aggregate_min(attachedAggregate); })
+INDEX_BENCHMARK(range_sum, { int result; range_sum(list, index, index + random_below(len - index), &result); sink += result; })
+INDEX_BENCHMARK(range_min, { int result; range_min(list, index, index + random_below(len - index), &result); sink += result; })
+INDEX_BENCHMARK(range_max, { int result; range_max(list, index, index + random_below(len - index), &result); sink += result; })
+INDEX_BENCHMARK(range_sum_replace, { int result; replace_at(data[index], list, index); range_sum(list, 0, index, &result); sink += result; })
+
+// Views
+LINEAR_BENCHMARK(create_view, { list_view_t view = create_view(list, is_positive, twice); sink += size(view_list(view)); destroy_view(&view); })
+LINEAR_BENCHMARK(refresh_view, { refresh_view(attachedView); sink += size(view_list(attachedView)); })
+
+// Memory layout and splices
+LINEAR_BENCHMARK(list_compact, list_compact(list))
+LINEAR_BENCHMARK(list_compact_step, while (list_compact_step(list, 1024) > 0);)
+LINEAR_BENCHMARK(list_locality, sink += (long long)(list_locality(list) * 1000))
+REPEATED_BENCHMARK(list_splice_back, { list_t other = create(); list_splice_back(other, list); list_splice_back(list, other); destroy(&other); })
+INDEX_BENCHMARK(list_splice_range,
+{
+	list_t other = create();
+	list_splice_range(other, 0, list, index, index + random_below(len - index));
+	list_splice_back(list, other);
+	destroy(&other);
+})
+
+// Text input and output
+LINEAR_BENCHMARK(list_write, { rewind(scratch); sink += list_write(scratch, list, "%d", "\n"); })
+LINEAR_BENCHMARK(list_sprint, sink += list_sprint(text, textLength + 1, list, "%d", "\n"))
+LINEAR_BENCHMARK(list_parse, discard(list_parse(text, textLength, '\n', NULL)))
+
+static const benchmarkCase cases[] =
+{
+	{ "generic", "add", bench_add, 0, TRUE, 0 },
+	{ "generic", "add_attached", bench_add, 0, TRUE, ATTACH_ALL },
+	{ "generic", "add_range", bench_add_range, 0, TRUE, 0 },
+	{ "generic", "copy", bench_copy, 0, FALSE, 0 },
+	{ "generic", "to_array", bench_to_array, 0, FALSE, 0 },
+	{ "generic", "clear", bench_clear, 0, TRUE, 0 },
+	{ "generic", "get_first", bench_get_first, 0, FALSE, 0 },
+	{ "generic", "get_last", bench_get_last, 0, FALSE, 0 },
+	{ "generic", "get", bench_get, LINEAR_LIMIT, FALSE, 0 },
+	{ "generic", "add_at", bench_add_at, LINEAR_LIMIT, TRUE, 0 },
+	{ "generic", "remove_at", bench_remove_at, LINEAR_LIMIT, TRUE, 0 },
+	{ "generic", "remove_at_attached", bench_remove_at, LINEAR_LIMIT, TRUE, ATTACH_ALL },
+	{ "generic", "replace_at", bench_replace_at, LINEAR_LIMIT, TRUE, 0 },
+	{ "generic", "replace_at_attached", bench_replace_at, LINEAR_LIMIT, TRUE, ATTACH_ALL },
+	{ "generic", "swap", bench_swap, LINEAR_LIMIT, TRUE, 0 },
+	{ "generic", "index_of", bench_index_of, LINEAR_LIMIT, FALSE, 0 },
+	{ "generic", "last_index_of", bench_last_index_of, LINEAR_LIMIT, FALSE, 0 },
+	{ "generic", "is_element", bench_is_element, LINEAR_LIMIT, FALSE, 0 },
+	{ "generic", "is_element_missing", bench_is_element_missing, LINEAR_LIMIT, FALSE, 0 },
+	{ "generic", "remove_item", bench_remove_item, LINEAR_LIMIT, TRUE, 0 },
+	{ "index", "is_element", bench_is_element, 0, FALSE, ATTACH_INDEX },
+	{ "index", "is_element_missing", bench_is_element_missing, 0, FALSE, ATTACH_INDEX },
+	{ "index", "remove_item", bench_remove_item, 0, TRUE, ATTACH_INDEX },
+	{ "filter", "is_element_missing", bench_is_element_missing, 0, FALSE, ATTACH_FILTER },
+	{ "linq", "where", bench_where, 0, FALSE, 0 },
+	{ "linq", "count", bench_count, 0, FALSE, 0 },
+	{ "linq", "count_ctx", bench_count_ctx, 0, FALSE, 0 },
+	{ "linq", "count_lambda", bench_count_lambda, 0, FALSE, 0 },
+	{ "linq", "count_batch", bench_count_batch, 0, FALSE, 0 },
+	{ "linq", "any", bench_any, 0, FALSE, 0 },
+	{ "linq", "all", bench_all, 0, FALSE, 0 },
+	{ "linq", "any_ctx", bench_any_ctx, 0, FALSE, 0 },
+	{ "linq", "all_ctx", bench_all_ctx, 0, FALSE, 0 },
+	{ "linq", "single", bench_single, 0, FALSE, 0 },
+	{ "linq", "first_or_default", bench_first_or_default, 0, FALSE, 0 },
+	{ "linq", "first_or_default_ctx", bench_first_or_default_ctx, 0, FALSE, 0 },
+	{ "linq", "last_or_default", bench_last_or_default, 0, FALSE, 0 },
+	{ "linq", "first_index_where", bench_first_index_where, 0, FALSE, 0 },
+	{ "linq", "last_index_where", bench_last_index_where, 0, FALSE, 0 },
+	{ "linq", "take_while", bench_take_while, 0, FALSE, 0 },
+	{ "linq", "take_range", bench_take_range, 0, FALSE, 0 },
+	{ "linq", "take_range_into", bench_take_range_into, 0, FALSE, 0 },
+	{ "linq", "skip", bench_skip, 0, FALSE, 0 },
+	{ "linq", "skip_while", bench_skip_while, 0, FALSE, 0 },
+	{ "linq", "trim", bench_trim, 0, FALSE, 0 },
+	{ "linq", "concat", bench_concat, 0, FALSE, 0 },
+	{ "linq", "zip", bench_zip, 0, FALSE, 0 },
+	{ "linq", "for_each", bench_for_each, 0, FALSE, 0 },
+	{ "linq", "for_each_ctx", bench_for_each_ctx, 0, FALSE, 0 },
+	{ "linq", "inverse_for_each", bench_inverse_for_each, 0, FALSE, 0 },
+	{ "linq", "reverse", bench_reverse, 0, FALSE, 0 },
+	{ "linq", "reverse_range", bench_reverse_range, 0, FALSE, 0 },
+	{ "linq", "sum", bench_sum, 0, FALSE, 0 },
+	{ "linq", "average", bench_average, 0, FALSE, 0 },
+	{ "linq", "get_numeric_min", bench_get_numeric_min, 0, FALSE, 0 },
+	{ "linq", "get_numeric_max", bench_get_numeric_max, 0, FALSE, 0 },
+	{ "linq", "get_min", bench_get_min, 0, FALSE, 0 },
+	{ "linq", "get_max", bench_get_max, 0, FALSE, 0 },
+	{ "linq", "where_ctx", bench_where_ctx, 0, FALSE, 0 },
+	{ "linq", "remove_where", bench_remove_where, 0, FALSE, 0 },
+	{ "linq", "remove_where_ctx", bench_remove_where_ctx, 0, FALSE, 0 },
+	{ "linq", "replace_where", bench_replace_where, 0, FALSE, 0 },
+	{ "linq", "derive", bench_derive, 0, FALSE, 0 },
+	{ "linq", "derive_ctx", bench_derive_ctx, 0, FALSE, 0 },
+	{ "linq", "sequence_equals", bench_sequence_equals, 0, FALSE, 0 },
+	{ "linq", "where_batch", bench_where_batch, 0, FALSE, 0 },
+	{ "linq", "remove_where_batch", bench_remove_where_batch, 0, FALSE, 0 },
+	{ "linq", "replace_where_batch", bench_replace_where_batch, 0, FALSE, 0 },
+	{ "linq", "filter_in_place", bench_filter_in_place, 0, TRUE, 0 },
+	{ "linq", "remove_where_in_place", bench_remove_where_in_place, 0, TRUE, 0 },
+	{ "linq", "replace_where_in_place", bench_replace_where_in_place, 0, TRUE, 0 },
+	{ "linq", "derive_in_place", bench_derive_in_place, 0, TRUE, 0 },
+	{ "linq", "reverse_in_place", bench_reverse_in_place, 0, TRUE, 0 },
+	{ "linq", "where_into", bench_where_into, 0, FALSE, 0 },
+	{ "linq", "derive_into", bench_derive_into, 0, FALSE, 0 },
+	{ "linq", "distinct", bench_distinct, QUADRATIC_LIMIT, FALSE, 0 },
+	{ "linq", "distinct_ctx", bench_distinct_ctx, QUADRATIC_LIMIT, FALSE, 0 },
+	{ "linq", "count_distinct", bench_count_distinct, QUADRATIC_LIMIT, FALSE, 0 },
+	{ "linq", "join", bench_join, QUADRATIC_LIMIT, FALSE, 0 },
+	{ "linq", "join_where", bench_join_where, QUADRATIC_LIMIT, FALSE, 0 },
+	{ "linq", "intersect", bench_intersect, QUADRATIC_LIMIT, FALSE, 0 },
+	{ "linq", "except", bench_except, QUADRATIC_LIMIT, FALSE, 0 },
+	{ "iterator", "next", bench_iterator_next, 0, FALSE, 0 },
+	{ "iterator", "next_batch", bench_next_batch, 0, FALSE, 0 },
+	{ "iterator", "next_span", bench_next_span, 0, FALSE, 0 },
+	{ "iterator", "iterator_remove", bench_iterator_remove, 0, TRUE, 0 },
+	{ "stack", "push", bench_push, 0, TRUE, 0 },
+	{ "stack", "pop", bench_pop, 0, TRUE, 0 },
+	{ "stack", "peek", bench_peek, 0, FALSE, 0 },
+	{ "sort", "order_by", bench_order_by, 0, FALSE, 0 },
+	{ "sort", "order_by_descending", bench_order_by_descending, 0, FALSE, 0 },
+	{ "sort", "order_by_ctx", bench_order_by_ctx, 0, FALSE, 0 },
+	{ "sort", "order_by_descending_ctx", bench_order_by_descending_ctx, 0, FALSE, 0 },
+	{ "sort", "order_by_into", bench_order_by_into, 0, FALSE, 0 },
+	{ "sort", "in_place_order_by", bench_in_place_order_by, QUADRATIC_LIMIT, FALSE, 0 },
+	{ "aggregate", "aggregate_sum", bench_aggregate_sum, 0, FALSE, ATTACH_AGGREGATE },
+	{ "aggregate", "aggregate_min", bench_aggregate_min, 0, FALSE, ATTACH_AGGREGATE },
+	{ "aggregate", "aggregate_max", bench_aggregate_max, 0, FALSE, ATTACH_AGGREGATE },
+	{ "aggregate", "aggregate_min_remove", bench_aggregate_min_remove, LINEAR_LIMIT, TRUE, ATTACH_AGGREGATE },
+	{ "range", "range_sum", bench_range_sum, 0, FALSE, ATTACH_RANGES },
+	{ "range", "range_min", bench_range_min, 0, FALSE, ATTACH_RANGES },
+	{ "range", "range_max", bench_range_max, 0, FALSE, ATTACH_RANGES },
+	{ "range", "range_sum_replace", bench_range_sum_replace, LINEAR_LIMIT, TRUE, ATTACH_RANGES },
+	{ "view", "create_view", bench_create_view, 0, FALSE, 0 },
+	{ "view", "refresh_view", bench_refresh_view, 0, FALSE, ATTACH_VIEW },
+	{ "memory", "list_compact", bench_list_compact, 0, TRUE, 0 },
+	{ "memory", "list_compact_step", bench_list_compact_step, 0, TRUE, 0 },
+	{ "memory", "list_locality", bench_list_locality, 0, FALSE, 0 },
+	{ "memory", "list_splice_back", bench_list_splice_back, 0, FALSE, 0 },
+	{ "memory", "list_splice_range", bench_list_splice_range, LINEAR_LIMIT, TRUE, 0 },
+	{ "text", "list_write", bench_list_write, 0, FALSE, 0 },
+	{ "text", "list_sprint", bench_list_sprint, 0, FALSE, 0 },
+	{ "text", "list_parse", bench_list_parse, 0, FALSE, 0 }
+};
+
+/* ============= Measurement ============= */
+
+// Returns the current time of the monotonic clock, in nanoseconds
+static inline long long now()
+{
+	struct timespec time;
+	clock_gettime(CLOCK_MONOTONIC, &time);
+	return time.tv_sec * 1000000000LL + time.tv_nsec;
+}
+
+// Compares two samples, used to sort them with qsort
+static int compare_samples(const void* a, const void* b)
+{
+	double first = *(const double*)a, second = *(const double*)b;
+	return first > second ? 1 : first < second ? -1 : 0;
+}
+
+// Statistics of the samples of a benchmark, in nanoseconds per operation
+typedef struct
+{
+	int samples;
+	long long operations;
+	double median;
+	double p99;
+	double min;
+} benchmarkResult;
+
+// Runs a benchmark with the given data until enough samples have been collected
+static benchmarkResult measure(const benchmarkCase* test, const T* data, int len)
+{
+	double samples[MAX_SAMPLES];
+	benchmarkResult result = { 0, 0, 0, 0, 0 };
+	list_t list = create_attached(data, len, test->attachments);
+	long long total = 0;
+	while (result.samples < MAX_SAMPLES && (result.samples < MIN_SAMPLES || total < TARGET_TIME))
+	{
+		// The list_t is created again outside of the measured time if the benchmark edits it
+		if (test->edits && result.samples > 0)
+		{
+			destroy_attached(&list);
+			list = create_attached(data, len, test->attachments);
+		}
+		long long start = now();
+		long long operations = test->function(list, data, len);
+		long long elapsed = now() - start;
+		total += elapsed;
+		result.operations = operations;
+		samples[result.samples++] = operations > 0 ? (double)elapsed / operations : 0;
+	}
+	destroy_attached(&list);
+
+	// Nearest rank percentiles
+	qsort(samples, result.samples, sizeof(double), compare_samples);
+	result.median = samples[(result.samples - 1) / 2];
+	result.p99 = samples[(result.samples * 99 + 99) / 100 - 1];
+	result.min = samples[0];
+	return result;
+}
+
+/* ============= Output ============= */
+
+static void print_header(outputFormat format)
+{
+	if (format == FORMAT_CSV) printf("group,benchmark,distribution,length,samples,operations,median_ns,p99_ns,min_ns\n");
+	else if (format == FORMAT_JSON) printf("{\n  \"unit\": \"ns/op\",\n  \"results\": [");
+	else printf("%-9s %-22s %-11s %9s %7s %12s %12s %12s\n",
+		"group", "benchmark", "data", "length", "samples", "median ns", "p99 ns", "min ns");
+}
+
+static void print_result(outputFormat format, const benchmarkCase* test, const char* data,
+	int len, benchmarkResult result, bool_t first)
+{
+	if (format == FORMAT_CSV)
+	{
+		printf("%s,%s,%s,%d,%d,%lld,%.3f,%.3f,%.3f\n", test->group, test->name, data, len,
+			result.samples, result.operations, result.median, result.p99, result.min);
+	}
+	else if (format == FORMAT_JSON)
+	{
+		printf("%s\n    { \"group\": \"%s\", \"benchmark\": \"%s\", \"distribution\": \"%s\", \"length\": %d, "
+			"\"samples\": %d, \"operations\": %lld, \"median_ns\": %.3f, \"p99_ns\": %.3f, \"min_ns\": %.3f }",
+			first ? "" : ",", test->group, test->name, data, len, result.samples, result.operations,
+			result.median, result.p99, result.min);
+	}
+	else
+	{
+		printf("%-9s %-22s %-11s %9d %7d %12.2f %12.2f %12.2f\n", test->group, test->name, data, len,
+			result.samples, result.median, result.p99, result.min);
+	}
+	fflush(stdout);
+}
+
+static void print_footer(outputFormat format)
+{
+	if (format == FORMAT_JSON) printf("\n  ]\n}\n");
+}
+
+/* ============= Main ============= */
+
+int main(int argc, char** argv)
+{
+	outputFormat format = FORMAT_TEXT;
+	int maxLength = DEFAULT_MAX_LENGTH, i;
+	const char* filter = NULL;
+	for (i = 1; i < argc; i++)
+	{
+		if (strcmp(argv[i], "--csv") == 0) format = FORMAT_CSV;
+		else if (strcmp(argv[i], "--json") == 0) format = FORMAT_JSON;
+		else if (strcmp(argv[i], "--max") == 0 && i + 1 < argc) maxLength = atoi(argv[++i]);
+		else if (strcmp(argv[i], "--filter") == 0 && i + 1 < argc) filter = argv[++i];
+		else
+		{
+			fprintf(stderr, "Usage: %s [--csv | --json] [--max LENGTH] [--filter TEXT]\n", argv[0]);
+			return 1;
+		}
+	}
+	if (maxLength > MAX_LENGTH) maxLength = MAX_LENGTH;
+	scratch = tmpfile();
+	if (scratch == NULL)
+	{
+		fprintf(stderr, "Unable to create a temporary file\n");
+		return 1;
+	}
+
+	// The data of each length and distribution is generated once and shared by all the benchmarks
+	T* data = (T*)malloc(maxLength * sizeof(T));
+	int caseCount = sizeof(cases) / sizeof(cases[0]);
+	int distributionCount = sizeof(distributions) / sizeof(distributions[0]);
+	bool_t first = TRUE;
+	int len, d, c;
+	print_header(format);
+	for (len = 100; len <= maxLength; len *= 10)
+	{
+		for (d = 0; d < distributionCount; d++)
+		{
+			randomState = 2463534242u;
+			distributions[d].fill(data, len);
+			build_text(data, len);
+			for (c = 0; c < caseCount; c++)
+			{
+				const benchmarkCase* test = cases + c;
+				if (test->limit > 0 && len > test->limit) continue;
+				if (filter != NULL && strstr(test->name, filter) == NULL && strcmp(test->group, filter) != 0) continue;
+				randomState = 88172645u;
+				benchmarkResult result = measure(test, data, len);
+				print_result(format, test, distributions[d].name, len, result, first);
+				first = FALSE;
+			}
+		}
+		if (len > INT_MAX / 10) break;
+	}
+	print_footer(format);
+	fclose(scratch);
+	free(text);
+	free(data);
+	return 0;
+}
+
+/* Copyright (C) 2015 Sergio Pedri
+
+* This library is free software; you can redistribute it and/or
+* modify it under the terms of the GNU Lesser General Public
+* License as published by the Free Software Foundation; either
+* version 2.1 of the License, or (at your option) any later version.
+
+* This library is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+* Lesser General Public License for more details.
+
+* You should have received a copy of the GNU Lesser General Public
+* License along with this library; If not, see http://www.gnu.org/licenses/
+*/
@@ -14,15 +14,19 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
-#include <time.h>
 #include "Library\list_t.h"
+#include "Library\list_template.h"
+#include "Library\Serialization\serialization.h"
+#include "Library\ExternalSort\external_sort.h"
+#include "Library\AsyncLoader\async_loader.h"
 
 void getch();
 void generic_functions_test();
 void stack_test();
 void LINQ_test();
 void iterator_test();
-void sorting_benchmarks();
+void typed_lists_test();
+void sorting_test();
 
 #define BOOL_STRING(value) value ? "True" : "False"
 #define NULL_STRING(value) BOOL_STRING(value == NULL)
@@ -42,11 +46,45 @@ int main(void)
 	stack_test();
 	LINQ_test();
 	iterator_test();
-	sorting_benchmarks();
+	typed_lists_test();
+	sorting_test();
 	printf("\n\n======== TESTS COMPLETED ========\n");
 	return 0;
 }
 
+// Hash function used to index a list_t of int values
+static unsigned int int_hash(int value)
+{
+	return (unsigned int)value * 2654435761u;
+}
+
+#ifdef LIST_T_OBSERVERS
+
+// Observer that prints the events of a list_t
+static void print_event(list_t list, list_operation op, int index,
+	const int* old_item, const int* new_item, void* ctx)
+{
+	static const char* names[] = { "ADD", "REMOVE", "REPLACE", "CLEAR", "REORDER" };
+	(void)list;
+	(void)ctx;
+	printf("\n>> %s event in index %d", names[op], index);
+	if (old_item != NULL) printf(", old item: %d", *old_item);
+	if (new_item != NULL) printf(", new item: %d", *new_item);
+}
+
+// Observer that stores the index of the last event inside its context
+static void store_index(list_t list, list_operation op, int index,
+	const int* old_item, const int* new_item, void* ctx)
+{
+	(void)list;
+	(void)op;
+	(void)old_item;
+	(void)new_item;
+	*(int*)ctx = index;
+}
+
+#endif
+
 /* ---------------------------------------------------------------------
 *  GenericFunctionsTest
 *  ---------------------------------------------------------------------
@@ -176,6 +214,24 @@ void generic_functions_test()
 	expected += 3;
 	PRINT_EXPECTED_SIZE;
 
+	// ListSpliceBack, ListSpliceRange
+	list_t toMove = create_random(4, 1, 10);
+	printf("\n\n>> Created a list_t with 4 elements:\n");
+	formatted_print("%d", toMove);
+	list_t moved = create();
+	list_splice_range(moved, 0, toMove, 1, 2);
+	printf("\n\n>> Items 1 and 2 moved to a new list_t:\n");
+	formatted_print("%d", moved);
+	printf("\n\n>> Remaining items:\n");
+	formatted_print("%d", toMove);
+	list_splice_back(moved, toMove);
+	printf("\n\n>> Remaining items moved at the end of the new list_t:\n");
+	formatted_print("%d", moved);
+	printf("\n\n>> Source list_t: ");
+	formatted_print("%d", toMove);
+	destroy(&toMove);
+	destroy(&moved);
+
 	// Size
 	printf("\n\n>> Size of the list_t: %d", size(test));
 
@@ -249,6 +305,110 @@ void generic_functions_test()
 	swap(test, 2, 5);
 	swap(test, 3, 7);
 	PRINT_LIST;
+
+	// ListCompact, ListLocality
+	printf("\n\n>> Locality of the list_t: %f", list_locality(test));
+	list_compact(test);
+	printf("\n>> Locality after the compaction: %f", list_locality(test));
+
+	// EnableHashIndex, DisableHashIndex
+	printf("\n\n>> Add 20 random items between 0 and 9, skipping duplicates:\n");
+	clear(test);
+	enable_hash_index(test, int_hash);
+	for (i = 0; i < 20; i++)
+	{
+		int value = rand() % 10;
+		if (!is_element(value, test)) add(value, test);
+	}
+	PRINT_LIST;
+	printf("\n>> Remove 5: ");
+	PRINT_BOOL(remove_item(5, test));
+	printf("\n>> Is 5 an element? ");
+	PRINT_BOOL(is_element(5, test));
+	disable_hash_index(test);
+
+	// EnableBloomFilter, RebuildBloomFilter
+	printf("\n\n>> Enable a Bloom filter, then look for 5 and 7:");
+	enable_bloom_filter(test, int_hash, 100, 0.01f);
+	printf("\n>> Is 5 an element? ");
+	PRINT_BOOL(is_element(5, test));
+	printf("\n>> Is 7 an element? ");
+	PRINT_BOOL(is_element(7, test));
+	remove_item(7, test);
+	rebuild_bloom_filter(test);
+	disable_bloom_filter(test);
+
+#ifdef LIST_T_OBSERVERS
+	// AddObserver, RemoveObserver
+	printf("\n\n>> Add an observer, then add 42, replace it with 43 and remove it:");
+	add_observer(test, print_event, NULL);
+	add(42, test);
+	replace_at(43, test, size(test) - 1);
+	remove_at(test, size(test) - 1);
+	remove_observer(test, print_event, NULL);
+
+	// The index of the events must be right even after editing the list_t with no observers
+	printf("\n>> Edit the list_t while it has no observers, then add one again: ");
+	list_t observed = create();
+	int lastIndex = -1;
+	for (i = 0; i < 10; i++) add(i, observed);
+	add_observer(observed, store_index, &lastIndex);
+	remove_at(observed, 5);
+	remove_observer(observed, store_index, &lastIndex);
+	remove_at(observed, 4);
+	remove_at(observed, 3);
+	add_observer(observed, store_index, &lastIndex);
+	add_at(99, observed, 4);
+	PRINT_BOOL(lastIndex == 4);
+	destroy(&observed);
+#endif
+
+	// ListWrite, ListSprint
+	printf("\n\n>> Write the list_t with a custom separator:\n");
+	list_write(stdout, test, "%d", " | ");
+	char text[16];
+	length = list_sprint(text, sizeof(text), test, "%d", ", ");
+	printf("\n>> Text inside a 16 chars buffer: \"%s\" (full length: %d)", text, length);
+
+	// ListParse
+	printf("\n>> Parse the text \"4, -8,15 ,16\":\n");
+	list_t parsed = list_parse("4, -8,15 ,16", 12, ',', NULL);
+	formatted_print("%d", parsed);
+	destroy(&parsed);
+
+	// ListLoadAsync, LoaderWait
+	printf("\n>> Write the list_t to a text file and load it in the background:\n");
+	FILE* stream = fopen("list_t.txt", "w");
+	list_write(stream, test, "%d", "\n");
+	fclose(stream);
+	list_loader_t loader = list_load_async("list_t.txt", '\n', NULL, 2, NULL, NULL);
+	parsed = loader_wait(&loader);
+	formatted_print("%d", parsed);
+	destroy(&parsed);
+	remove("list_t.txt");
+
+	// ListSave, ListLoad, ListMap
+	printf("\n\n>> Save the list_t to a binary file and load it back:\n");
+	list_save(test, "list_t.bin");
+	list_t loaded = list_load("list_t.bin");
+	formatted_print("%d", loaded);
+	destroy(&loaded);
+	list_mapping_t mapping = list_map("list_t.bin");
+	int mapped;
+	const T* items = mapping_data(mapping, &mapped);
+	printf("\n>> Mapped items: %d, first item: %d", mapped, items[0]);
+	list_unmap(&mapping);
+
+	// ExternalOrderBy
+	printf("\n>> Sort the binary file with a 1MB memory budget:\n");
+	external_order_by("list_t.bin", "list_t.bin", comparator(a, b,
+	{
+		return a > b ? LOWER : a == b ? EQUAL : GREATER;
+	}), 1 << 20);
+	loaded = list_load("list_t.bin");
+	formatted_print("%d", loaded);
+	destroy(&loaded);
+	remove("list_t.bin");
 	destroy(&test);
 }
 
@@ -358,6 +518,21 @@ void LINQ_test()
 	PRINT_TEMP;
 	DISPOSE_TEMP;
 
+	// WhereBatch
+	temp = where_batch(test, batchSelector(items, n, mask,
+	{
+		int i;
+		for (i = 0; i < n; i++) mask[i] = !(items[i] % 3) && items[i] != 0;
+	}));
+	printf("\n\n>> Same list, using a batch selector:\n");
+	PRINT_TEMP;
+	printf("\n>> Count with a batch selector: %d", count_batch(test, batchSelector(items, n, mask,
+	{
+		int i;
+		for (i = 0; i < n; i++) mask[i] = !(items[i] % 3) && items[i] != 0;
+	})));
+	DISPOSE_TEMP;
+
 	// TakeWhile
 	temp = take_while(test, selector(item, 
 	{
@@ -483,6 +658,38 @@ void LINQ_test()
 	result = average(test, toNumber(item, { return item; }));
 	printf("\n\n>> Average: %d", result);
 
+	// RegisterAggregate, AggregateSum, AggregateMin, AggregateMax
+	list_aggregate_t stats = register_aggregate(test, toNumber(item, { return item; }));
+	add(1000, test);
+	printf("\n\n>> Add 1000, incremental sum: %d, min: %d, max: %d",
+		aggregate_sum(stats), aggregate_min(stats), aggregate_max(stats));
+	remove_item(1000, test);
+	printf("\n>> Remove 1000, incremental sum: %d, max: %d", aggregate_sum(stats), aggregate_max(stats));
+	unregister_aggregate(test, &stats);
+
+	// EnableRangeQueries, RangeSum, RangeMax
+	enable_range_queries(test, toNumber(item, { return item; }));
+	range_sum(test, 2, 5, &result);
+	printf("\n\n>> Sum of the items from indexes 2 to 5: %d", result);
+	get(test, 3, &value);
+	replace_at(500, test, 3);
+	range_max(test, 2, 5, &result);
+	printf("\n>> Replace index 3 with 500, max from indexes 2 to 5: %d", result);
+	replace_at(value, test, 3);
+	disable_range_queries(test);
+
+	// CreateView, ViewList, DestroyView
+	printf("\n\n>> View with the positive items multiplied by 10:\n");
+	list_view_t view = create_view(test, selector(item, { return item > 0; }), deriver(item, { return item * 10; }));
+	formatted_print("%d", view_list(view));
+	printf("\n>> Add 7, the view is updated:\n");
+	add(7, test);
+	formatted_print("%d", view_list(view));
+	printf("\n>> Remove it, the view is updated:\n");
+	remove_at(test, size(test) - 1);
+	formatted_print("%d", view_list(view));
+	destroy_view(&view);
+
 	// Min
 	comparation(*expression)(T, T) = comparator(item1, item2,
 	{
@@ -559,6 +766,24 @@ void LINQ_test()
 	PRINT_BOOL(bool_tResult);
 	DISPOSE_TEMP;
 
+	// FilterInPlace, ReverseInPlace
+	temp = copy(test);
+	result = filter_in_place(temp, selector(item, { return item > 0; }));
+	reverse_in_place(temp);
+	printf("\n\n>> Keep the positive items of a copy and reverse it, in place (%d removed):\n", result);
+	PRINT_TEMP;
+	DISPOSE_TEMP;
+
+	// WhereInto, OrderByInto
+	temp = create();
+	where_into(temp, test, selector(item, { return item < 0; }));
+	printf("\n\n>> Negative items, stored into an existing list_t:\n");
+	PRINT_TEMP;
+	order_by_into(temp, test, expression);
+	printf("\n\n>> Same list_t reused to store the ordered items:\n");
+	PRINT_TEMP;
+	DISPOSE_TEMP;
+
 	// Trim
 	printf("\n\n>> Trim the list to a maximum length of 7:\n");
 	temp = trim(test, 7);
@@ -632,53 +857,126 @@ void iterator_test()
 	result = destroy_iterator(&iterator);
 	printf("\n\n>> Iterator destroyed, is NULL: ");
 	PRINT_BOOL(result);
+
+	// IteratorInit
+	printf("\n\n>> Items from an iterator allocated on the stack:\n");
+	struct listIterator local;
+	int len;
+	if (iterator_init(&local, test))
+	{
+		while (next(&local, &value)) printf("%d ", value);
+	}
+
+	// NextBatch, PrevBatch
+	T block[3];
+	iterator_init(&local, test);
+	len = next_batch(&local, block, 3);
+	printf("\n\n>> Next batch of %d items: %d %d %d", len, block[0], block[1], block[2]);
+	len = next_batch(&local, block, 3);
+	printf("\n>> Next batch of %d items: %d %d %d", len, block[0], block[1], block[2]);
+	len = prev_batch(&local, block, 2);
+	printf("\n>> Previous batch of %d items: %d %d, position %d",
+		   len, block[0], block[1], actual_position(&local));
+
+	// IteratorRemove, IteratorInsertAfter
+	printf("\n\n>> Remove the negative items and add a 0 after the even ones:\n");
+	list_t edited = copy(test);
+	iterator_init(&local, edited);
+	while (next(&local, &value))
+	{
+		if (value < 0) iterator_remove(&local);
+		else if (!(value % 2))
+		{
+			iterator_insert_after(&local, 0);
+			move_next(&local);
+		}
+	}
+	formatted_print("%d", edited);
+	destroy(&edited);
+
+	// SpanIterator
+	printf("\n\n>> Blocks of 4 items from a span iterator:");
+	T buffer[4];
+	list_span_iterator_t spans = get_span_iterator(test, buffer, 4);
+	const T* data;
+	int i;
+	while (next_span(spans, &data, &len))
+	{
+		printf("\n");
+		for (i = 0; i < len; i++) printf("%d ", data[i]);
+	}
+	destroy_span_iterator(&spans);
+	printf("\n>> Span iterator with a buffer and no capacity is NULL: ");
+	PRINT_NULL(get_span_iterator(test, buffer, 0));
 }
 
-// Returns the local clock time
-inline float get_time()
+// Typed list of integers, the comparator is expanded inline
+#define INT_CMP(a, b) ((a) > (b) ? GREATER : (a) < (b) ? LOWER : EQUAL)
+DECLARE_LIST(ilist, int)
+DEFINE_LIST(ilist, int, INT_CMP)
+
+// Typed list of points, ordered by their distance from the origin
+struct point { int x, y; };
+static inline comparation point_cmp(struct point a, struct point b)
 {
-	return (float)clock() / CLOCKS_PER_SEC;
+	int first = a.x * a.x + a.y * a.y, second = b.x * b.x + b.y * b.y;
+	if (first > second) return GREATER;
+	if (second > first) return LOWER;
+	return EQUAL;
 }
+DECLARE_LIST(plist, struct point)
+DEFINE_LIST(plist, struct point, point_cmp)
 
-// Performs a simple benchmark with the two sorting algorithms
-void perform_benchmark(int len, comparation(*expression)(T, T))
+/* ---------------------------------------------------------------------
+*  TypedListsTest
+*  ---------------------------------------------------------------------
+*  Description:
+*    Shows two lists with different element types generated with the
+*    DECLARE_LIST and DEFINE_LIST macros inside the same program. */
+void typed_lists_test()
 {
-	printf("\n\n>> Test with %d elements", len);
-	list_t test, sorted;
-	float totalIntro = 0, totalBubble = 0;
+	printf("\n\n======== TYPED LISTS ========\n\n");
+
+	// Integers
+	ilist_t numbers = ilist_create();
 	int i;
-	for (i = 0; i < 10; i++)
+	for (i = 0; i < 10; i++) ilist_add((i * 7) % 10, numbers);
+	ilist_t sorted = ilist_order_by(numbers);
+	printf(">> Sorted ilist_t: ");
+	struct ilistElem* node;
+	for (node = sorted->head; node != NULL; node = node->next)
 	{
-		test = create_random(len, -len, len);
-		float start, end;
-		start = get_time();
-		sorted = order_by(test, expression);
-		end = get_time();
-		destroy(&sorted);
-		totalIntro += end - start;
+		printf("%d ", node->info);
 	}
-	printf("\n\n>> Total intro: %f", totalIntro);
-	for (i = 0; i < 10; i++)
+	printf("\n\n>> 7 is element: ");
+	PRINT_BOOL(ilist_is_element(7, numbers));
+	ilist_destroy(&sorted);
+	ilist_destroy(&numbers);
+
+	// Points
+	plist_t points = plist_create();
+	for (i = 0; i < 5; i++)
 	{
-		test = create_random(len, -len, len);
-		float start, end;
-		start = get_time();
-		sorted = in_place_order_by(test, expression);
-		end = get_time();
-		destroy(&sorted);
-		totalBubble += end - start;
+		struct point p = { 5 - i, i % 3 };
+		plist_add(p, points);
 	}
-	printf("\n>> Total bubble: %f", totalBubble);
+	struct point nearest;
+	plist_get_min(points, &nearest);
+	printf("\n\n>> Point nearest to the origin: (%d, %d)", nearest.x, nearest.y);
+	plist_destroy(&points);
 }
 
 /* ---------------------------------------------------------------------
-*  SortingBenchmarks
+*  SortingTest
 *  ---------------------------------------------------------------------
 *  Description:
-*    Tests the performances of the two sorting algorithms available */
-void sorting_benchmarks()
+*    Checks that the two sorting algorithms return the same items.
+*  NOTE:
+*    The performances of the library are measured by the benchmark.c
+*    program instead, see the README file. */
+void sorting_test()
 {
-	printf("\n\n======== SORTING BENCHMARKS ========\n\n");
+	printf("\n\n======== SORTING TEST ========\n\n");
 
 	// Create random list_t
 	list_t test, sorted, compare;
@@ -703,15 +1001,13 @@ void sorting_benchmarks()
 		{
 			return n1 == n2;
 		}));
+		destroy(&test);
 		destroy(&sorted);
 		destroy(&compare);
 		if (!valid) break;
 		if (i % 2 == 0) printf(".");
 	}
 	printf("\n\n>> Success: %s", valid ? "YES! :)" : "NO :'(");
-	
-	perform_benchmark(1000, expression);
-	perform_benchmark(5000, expression);
 }
 
 /* Copyright (C) 2015 Sergio Pedri